@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include "fgloadgen/options.hpp"
+#include "fgloadgen/stats.hpp"
+#include "protocol/messages.hpp"
+#include "network/tcp_client.hpp"
+#include "network/tcp_server.hpp"
+
+namespace fgloadgen {
+// Built-in stand-in for fgmanager: answers every Command with a Status.
+class CommandServer {
+public:
+    CommandServer(boost::asio::io_context& io_context, std::string const& address,
+                  network::SocketOptions const& socket_options, Stats& stats);
+
+    void start();
+    void stop();
+
+    // Address clients connect to
+    [[nodiscard]] std::string address() const;
+
+private:
+    void handle_command(uint8_t const* data, std::size_t length, std::shared_ptr<network::TCPConnection> connection);
+
+    network::TCPServer server_;
+    Stats& stats_;
+};
+
+// Drives Command traffic over one TCP or Unix domain connection. One command is in flight at
+// a time, which gives clean round-trip measurements. Commands are sent on the
+// priority lane matching their type, and the client reconnects on its own if
+// the server goes away.
+class CommandClient {
+public:
+    CommandClient(boost::asio::io_context& io_context, uint32_t id, Options const& options, std::string target,
+                  Stats& stats, std::atomic<bool> const& sending);
+
+    void start();
+    void stop();
+
+private:
+    void send_next();
+    void handle_status(uint8_t const* data, std::size_t length);
+
+    network::TCPClient client_;
+    boost::asio::steady_timer timer_;
+    uint32_t id_;
+    std::string target_;
+    std::chrono::nanoseconds period_;
+    std::chrono::steady_clock::time_point next_send_;
+    std::chrono::steady_clock::time_point sent_at_;
+    std::vector<uint8_t> pending_;
+    protocol::CommandMessage::Type pending_type_{};
+    uint64_t sequence_;
+    bool awaiting_reply_;
+    Stats& stats_;
+    std::atomic<bool> const& sending_;
+};
+} // namespace fgloadgen
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include "protocol/messages.hpp"
+
+namespace fgloadgen {
+// Very small helicopter model used to produce plausible telemetry: collective
+// drives climb rate, cyclic tilts the disc, pedals yaw. It is not meant to fly
+// like the real aircraft, only to give the control path moving inputs.
+class FlightModel {
+public:
+    explicit FlightModel(uint32_t seed);
+
+    // Latest control inputs from the controller under test
+    void apply(protocol::ControlMessage::Control const& control);
+
+    // Advance the simulation by dt seconds
+    void step(double dt);
+
+    // Current state as a telemetry frame
+    [[nodiscard]] protocol::TelemetryMessage::Telemetry telemetry() const;
+
+private:
+    protocol::TelemetryMessage::Telemetry state_;
+    double phase_;
+};
+} // namespace fgloadgen
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "network/socket_options.hpp"
+
+namespace fgloadgen {
+// Host and port of an external peer
+struct Target {
+    std::string host;
+    int port;
+};
+
+// Command line configuration of a load run
+struct Options {
+    // FlightGear instances streaming telemetry
+    int instances = 1;
+    double telemetry_rate = 60.0; // Frames per second, per instance
+    std::size_t datagram_size = 0; // Pad telemetry datagrams to this size (0 = natural size)
+    std::optional<Target> telemetry_target; // Unset: built-in hoverlink stand-in
+
+    // TCP clients driving Command traffic
+    int command_clients = 0;
+    double command_rate = 0.0; // Commands per second, per client (0 = closed loop, as fast as possible)
+    // Command server address: host:port, unix:/path or @name (see network/address.hpp)
+    std::optional<std::string> command_target; // Unset: built-in fgmanager stand-in
+    std::string command_listen = "127.0.0.1:0"; // Where the built-in server listens
+
+    // Socket options for every socket of the run. Listing several profiles
+    // repeats the run once per profile and compares them at the end.
+    std::vector<network::SocketOptions> socket_profiles{network::SocketOptions::defaults()};
+    network::SocketOptions socket_options; // Profile of the current run
+
+    int threads = 1;
+    double duration = 10.0;       // Seconds
+    double report_interval = 1.0; // Seconds
+};
+
+// Parse --key=value arguments. Returns nullopt (after printing usage) on error.
+std::optional<Options> parse_options(int argc, char* argv[]);
+} // namespace fgloadgen
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace fgloadgen {
+// Measurement trailer appended after the FlatBuffer in every datagram the load
+// generator sends. FlatBuffers verification ignores trailing bytes, so real
+// receivers see an ordinary (possibly padded) message, while the built-in
+// receiver uses it for loss and latency accounting and echoes it back.
+struct ProbeTrailer {
+    static constexpr uint32_t MAGIC = 0x46474c47; // "FGLG"
+
+    uint32_t magic;
+    uint32_t instance;
+    uint64_t sequence;
+    int64_t send_time_ns; // steady_clock, only meaningful inside this process
+};
+
+static_assert(sizeof(ProbeTrailer) == 24);
+
+inline int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Append the trailer, zero-padding in front of it so the datagram is at least pad_to bytes
+inline void append_probe(std::vector<uint8_t>& datagram, ProbeTrailer const& probe, std::size_t pad_to = 0) {
+    if (datagram.size() + sizeof(ProbeTrailer) < pad_to) {
+        datagram.resize(pad_to - sizeof(ProbeTrailer), 0);
+    }
+    auto const offset = datagram.size();
+    datagram.resize(offset + sizeof(ProbeTrailer));
+    std::memcpy(datagram.data() + offset, &probe, sizeof(ProbeTrailer));
+}
+
+inline std::optional<ProbeTrailer> find_probe(uint8_t const* data, std::size_t length) {
+    if (length < sizeof(ProbeTrailer)) {
+        return std::nullopt;
+    }
+    ProbeTrailer probe{};
+    std::memcpy(&probe, data + length - sizeof(ProbeTrailer), sizeof(ProbeTrailer));
+    if (probe.magic != ProbeTrailer::MAGIC) {
+        return std::nullopt;
+    }
+    return probe;
+}
+} // namespace fgloadgen
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <boost/asio.hpp>
+#include "fgloadgen/flight_model.hpp"
+#include "fgloadgen/options.hpp"
+#include "fgloadgen/stats.hpp"
+#include "network/udp_client.hpp"
+
+namespace fgloadgen {
+// One emulated FlightGear instance: streams HelicopterTelemetry at a fixed rate
+// to the receiver under test and feeds the HelicopterControl replies back into
+// its flight model.
+class SimInstance {
+public:
+    SimInstance(boost::asio::io_context& io_context, uint32_t id, Options const& options,
+                boost::asio::ip::udp::endpoint const& target, Stats& stats, std::atomic<bool> const& sending);
+
+    void start();
+    void stop();
+
+private:
+    void schedule_tick();
+    void tick();
+    void send_frame(double dt);
+    void handle_control(uint8_t const* data, std::size_t length);
+
+    network::UDPClient udp_client_;
+    boost::asio::steady_timer timer_;
+    uint32_t id_;
+    std::size_t datagram_size_;
+    std::chrono::nanoseconds period_;
+    std::chrono::steady_clock::time_point next_tick_;
+    FlightModel model_;
+    uint64_t sequence_;
+    Stats& stats_;
+    std::atomic<bool> const& sending_;
+};
+} // namespace fgloadgen
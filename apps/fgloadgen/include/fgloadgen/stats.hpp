@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace fgloadgen {
+// Lock-free log-linear latency histogram (8 sub-buckets per power of two).
+// Recording is wait-free so it can be shared by all I/O threads.
+class LatencyHistogram {
+public:
+    void record(std::chrono::nanoseconds latency);
+
+    // Latency at the given quantile (0.0 - 1.0); zero if nothing was recorded
+    [[nodiscard]] std::chrono::nanoseconds quantile(double q) const;
+    [[nodiscard]] std::chrono::nanoseconds max() const;
+    [[nodiscard]] uint64_t count() const;
+
+    // Copy-and-clear, used for per-interval reporting
+    void drain_into(LatencyHistogram& other);
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int BUCKET_COUNT = 64 << SUB_BUCKET_BITS;
+
+    static std::size_t index_of(uint64_t value);
+    static uint64_t value_of(std::size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Counters shared by every emulated instance and client
+struct Stats {
+    // Telemetry stream (FlightGear -> hoverlink)
+    std::atomic<uint64_t> telemetry_sent{0};
+    std::atomic<uint64_t> telemetry_bytes{0};
+    std::atomic<uint64_t> telemetry_received{0}; // Seen by the built-in receiver
+    std::atomic<uint64_t> telemetry_lost{0};     // Sequence gaps seen by the built-in receiver
+
+    // Control replies (hoverlink -> FlightGear)
+    std::atomic<uint64_t> controls_received{0};
+    std::atomic<uint64_t> controls_invalid{0};
+
+    // Command traffic over TCP
+    std::atomic<uint64_t> commands_sent{0};
+    std::atomic<uint64_t> statuses_received{0};
+    std::atomic<uint64_t> command_failures{0};
+
+    LatencyHistogram telemetry_latency; // One-way, sender to built-in receiver
+    LatencyHistogram control_rtt;       // Telemetry send to control reply
+    LatencyHistogram command_rtt;       // Command send to status reply
+};
+
+// Human-readable duration for reports
+std::string format_duration(std::chrono::nanoseconds value);
+} // namespace fgloadgen
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <boost/asio.hpp>
+#include "fgloadgen/stats.hpp"
+#include "network/udp_client.hpp"
+
+namespace fgloadgen {
+// Built-in stand-in for hoverlink: consumes telemetry from every instance,
+// accounts for loss and one-way latency, and answers each frame with a
+// HelicopterControl computed by a trivial altitude-hold law.
+class TelemetrySink {
+public:
+    TelemetrySink(boost::asio::io_context& io_context, network::SocketOptions const& socket_options, Stats& stats);
+
+    void start();
+    void stop();
+
+    // Address instances should send telemetry to
+    [[nodiscard]] boost::asio::ip::udp::endpoint endpoint() const;
+
+private:
+    void handle_telemetry(uint8_t const* data, std::size_t length, boost::asio::ip::udp::endpoint const& sender);
+
+    network::UDPClient udp_client_;
+    std::unordered_map<uint32_t, uint64_t> last_sequence_;
+    Stats& stats_;
+};
+} // namespace fgloadgen
@@ -0,0 +1,187 @@
+#include "fgloadgen/command_load.hpp"
+#include "protocol/messages.hpp"
+
+namespace fgloadgen {
+namespace {
+// State changes jump the queue; configuration is the one large command
+network::Priority priority_of(protocol::CommandMessage::Type type) {
+    switch (type) {
+    case protocol::CommandMessage::Type::Stop:
+    case protocol::CommandMessage::Type::Pause:
+        return network::Priority::Urgent;
+    case protocol::CommandMessage::Type::Configure:
+        return network::Priority::Bulk;
+    default:
+        return network::Priority::Normal;
+    }
+}
+} // namespace
+
+// CommandServer implementation
+CommandServer::CommandServer(boost::asio::io_context& io_context, std::string const& address,
+    network::SocketOptions const& socket_options, Stats& stats)
+    : server_(io_context, address, socket_options),
+      stats_(stats) {
+    server_.set_connection_handler([this](std::shared_ptr<network::TCPConnection> connection) {
+        connection->set_message_handler(
+            [this](uint8_t const* data, std::size_t length, std::shared_ptr<network::TCPConnection> conn) {
+                this->handle_command(data, length, std::move(conn));
+            });
+    });
+}
+
+void CommandServer::start() {
+    server_.start();
+}
+
+void CommandServer::stop() {
+    server_.stop();
+}
+
+std::string CommandServer::address() const {
+    auto address = server_.get_local_address();
+    // Listening on every interface: connect over loopback
+    if (address.starts_with("0.0.0.0:")) {
+        address = "127.0.0.1:" + std::to_string(server_.get_local_port());
+    }
+    return address;
+}
+
+void CommandServer::handle_command(uint8_t const* data, std::size_t length,
+    std::shared_ptr<network::TCPConnection> connection) {
+    protocol::CommandMessage::Type type{};
+    protocol::CommandMessage::Config config;
+    if (!protocol::CommandMessage::parse(data, length, type, config)) {
+        stats_.command_failures.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    protocol::StatusMessage::StatusInfo info{};
+    switch (type) {
+    case protocol::CommandMessage::Type::Start:
+    case protocol::CommandMessage::Type::Resume:
+    case protocol::CommandMessage::Type::Configure:
+        info.status = protocol::StatusMessage::Status::Running;
+        break;
+    case protocol::CommandMessage::Type::Pause:
+        info.status = protocol::StatusMessage::Status::Paused;
+        break;
+    case protocol::CommandMessage::Type::Stop:
+    case protocol::CommandMessage::Type::Reset:
+        info.status = protocol::StatusMessage::Status::Idle;
+        break;
+    }
+    info.message = config.aircraft;
+
+    // The connection copies the reply into its send queue
+    auto const reply = protocol::StatusMessage::create(info);
+    connection->send_data(reply.data(), reply.size(), priority_of(type));
+}
+
+// CommandClient implementation
+CommandClient::CommandClient(boost::asio::io_context& io_context, uint32_t id, Options const& options,
+    std::string target, Stats& stats, std::atomic<bool> const& sending)
+    : client_(io_context, options.socket_options),
+      timer_(io_context),
+      id_(id),
+      target_(std::move(target)),
+      period_(options.command_rate > 0.0
+                  ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / options.command_rate))
+                  : std::chrono::nanoseconds(0)),
+      sequence_(0),
+      awaiting_reply_(false),
+      stats_(stats),
+      sending_(sending) {
+    client_.set_message_handler([this](uint8_t const* data, std::size_t length) {
+        this->handle_status(data, length);
+    });
+
+    // Ride out server restarts: the command in flight when the link dropped
+    // never got its reply, so send it again; otherwise (re)start the loop.
+    // That resend is the only replay, so nothing is kept in the offline queue
+    // (which would send the same command a second time).
+    network::ReconnectPolicy policy;
+    policy.enabled = true;
+    policy.offline_queue_bytes = 0;
+    client_.set_reconnect_policy(policy);
+    client_.set_restore_handler([this]() {
+        if (!awaiting_reply_) {
+            next_send_ = std::chrono::steady_clock::now();
+            send_next();
+            return;
+        }
+        sent_at_ = std::chrono::steady_clock::now();
+        client_.send_data(pending_.data(), pending_.size(), priority_of(pending_type_));
+    });
+}
+
+void CommandClient::start() {
+    client_.connect(target_, [this](bool connected) {
+        if (!connected) {
+            stats_.command_failures.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        next_send_ = std::chrono::steady_clock::now();
+        send_next();
+    });
+}
+
+void CommandClient::stop() {
+    timer_.cancel();
+    client_.disconnect();
+}
+
+void CommandClient::send_next() {
+    if (!sending_.load(std::memory_order_relaxed) || !client_.is_connected()) {
+        return;
+    }
+
+    // Mostly small state commands, with a Configure carrying strings now and then
+    auto const n = sequence_++;
+    if (n % 8 == 7) {
+        protocol::CommandMessage::Config config;
+        config.aircraft = "ec135p2";
+        config.airport = "KSFO";
+        config.time_of_day = "noon";
+        config.weather = "clear";
+        config.additional_args = {"--instance=" + std::to_string(id_), "--disable-sound"};
+        pending_type_ = protocol::CommandMessage::Type::Configure;
+        pending_ = protocol::CommandMessage::create(pending_type_, config);
+    } else {
+        pending_type_ = n % 2 == 0 ? protocol::CommandMessage::Type::Pause : protocol::CommandMessage::Type::Resume;
+        pending_ = protocol::CommandMessage::create(pending_type_);
+    }
+
+    awaiting_reply_ = true;
+    sent_at_ = std::chrono::steady_clock::now();
+    client_.send_data(pending_.data(), pending_.size(), priority_of(pending_type_));
+    stats_.commands_sent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CommandClient::handle_status(uint8_t const* data, std::size_t length) {
+    protocol::StatusMessage::StatusInfo info{};
+    if (!awaiting_reply_ || !protocol::StatusMessage::parse(data, length, info)) {
+        stats_.command_failures.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto const now = std::chrono::steady_clock::now();
+    awaiting_reply_ = false;
+    stats_.statuses_received.fetch_add(1, std::memory_order_relaxed);
+    stats_.command_rtt.record(now - sent_at_);
+
+    if (period_.count() == 0) {
+        send_next();
+        return;
+    }
+    next_send_ += period_;
+    if (next_send_ < now) {
+        next_send_ = now;
+    }
+    timer_.expires_at(next_send_);
+    timer_.async_wait([this](boost::system::error_code const& error) {
+        if (!error) {
+            this->send_next();
+        }
+    });
+}
+} // namespace fgloadgen
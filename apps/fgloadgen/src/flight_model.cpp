@@ -0,0 +1,71 @@
+#include "fgloadgen/flight_model.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace fgloadgen {
+namespace {
+constexpr double FEET_PER_DEGREE_LAT = 364'000.0;
+constexpr double KNOTS_TO_FPS = 1.68781;
+} // namespace
+
+FlightModel::FlightModel(uint32_t seed)
+    : state_{},
+      phase_(static_cast<double>(seed % 360) * std::numbers::pi / 180.0) {
+    // Spread instances around KSFO so their tracks differ
+    state_.latitude = 37.6189 + static_cast<double>(seed % 100) * 0.001;
+    state_.longitude = -122.375 + static_cast<double>(seed / 100 % 100) * 0.001;
+    state_.altitude = 500.0;
+    state_.heading = static_cast<float>(seed % 360);
+    state_.engine_rpm = 6000.0F;
+    state_.rotor_rpm = 395.0F;
+    state_.collective = 0.5F;
+    state_.temperature = 15.0F;
+}
+
+void FlightModel::apply(protocol::ControlMessage::Control const& control) {
+    state_.collective = std::clamp(control.collective, 0.0F, 1.0F);
+    state_.cyclic_lat = std::clamp(control.cyclic_lat, -1.0F, 1.0F);
+    state_.cyclic_lon = std::clamp(control.cyclic_lon, -1.0F, 1.0F);
+    state_.pedals = std::clamp(control.pedals, -1.0F, 1.0F);
+}
+
+void FlightModel::step(double dt) {
+    state_.sim_time += static_cast<float>(dt);
+    double const t = state_.sim_time;
+
+    // Gusty wind slowly rotating around the instance's own phase
+    state_.wind_speed = static_cast<float>(8.0 + 4.0 * std::sin(0.3 * t + phase_));
+    state_.wind_direction = static_cast<float>(std::fmod(270.0 + 20.0 * std::sin(0.05 * t + phase_) + 360.0, 360.0));
+
+    // First-order response of attitude to cyclic, yaw rate to pedals
+    double const response = std::min(1.0, 2.0 * dt);
+    state_.pitch += static_cast<float>((-20.0 * state_.cyclic_lon - state_.pitch) * response);
+    state_.roll += static_cast<float>((30.0 * state_.cyclic_lat - state_.roll) * response);
+    state_.heading = static_cast<float>(std::fmod(state_.heading + 30.0 * state_.pedals * dt + 360.0, 360.0));
+
+    // Collective above hover setting climbs, below descends (feet per minute)
+    double const target_vs = (state_.collective - 0.5) * 4000.0;
+    state_.vertical_speed += static_cast<float>((target_vs - state_.vertical_speed) * response);
+    state_.altitude = std::max(0.0, state_.altitude + state_.vertical_speed / 60.0 * dt);
+
+    // Nose-down pitch accelerates forward
+    double const target_speed = std::max(0.0, -state_.pitch * 5.0);
+    state_.airspeed += static_cast<float>((target_speed - state_.airspeed) * 0.5 * response);
+    state_.ground_speed = std::max(0.0F, state_.airspeed - state_.wind_speed * 0.5F);
+
+    double const heading_rad = state_.heading * std::numbers::pi / 180.0;
+    double const distance_ft = state_.ground_speed * KNOTS_TO_FPS * dt;
+    state_.latitude += distance_ft * std::cos(heading_rad) / FEET_PER_DEGREE_LAT;
+    state_.longitude += distance_ft * std::sin(heading_rad)
+                        / (FEET_PER_DEGREE_LAT * std::cos(state_.latitude * std::numbers::pi / 180.0));
+
+    state_.rotor_rpm = static_cast<float>(395.0 - 10.0 * (state_.collective - 0.5) + 0.5 * std::sin(10.0 * t));
+    state_.engine_rpm = state_.rotor_rpm * 15.19F;
+    state_.temperature = static_cast<float>(15.0 - 0.002 * state_.altitude);
+}
+
+protocol::TelemetryMessage::Telemetry FlightModel::telemetry() const {
+    return state_;
+}
+} // namespace fgloadgen
@@ -0,0 +1,288 @@
+// fgloadgen: FlightGear stand-in load generator.
+//
+// Emulates one or many FlightGear instances streaming HelicopterTelemetry and
+// consuming HelicopterControl, plus TCP clients driving Command traffic, and
+// reports achieved throughput, loss and latency. Without explicit targets it
+// also runs built-in hoverlink/fgmanager stand-ins so the network and protocol
+// libraries can be exercised on machines without FlightGear. Given several
+// --socket-profile options it repeats the run once per profile and prints a
+// latency/throughput comparison, e.g. over loopback:
+//     fgloadgen --instances=8 --command-clients=4 --duration=5
+//         --socket-profile=default --socket-profile=low-latency --socket-profile=bulk
+#include "fgloadgen/command_load.hpp"
+#include "fgloadgen/options.hpp"
+#include "fgloadgen/sim_instance.hpp"
+#include "fgloadgen/stats.hpp"
+#include "fgloadgen/telemetry_sink.hpp"
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Counter values at the previous report, for per-interval rates
+struct Snapshot {
+    uint64_t telemetry_sent = 0;
+    uint64_t telemetry_bytes = 0;
+    uint64_t telemetry_received = 0;
+    uint64_t controls_received = 0;
+    uint64_t statuses_received = 0;
+};
+
+Snapshot take_snapshot(fgloadgen::Stats const& stats) {
+    return {stats.telemetry_sent.load(), stats.telemetry_bytes.load(), stats.telemetry_received.load(),
+            stats.controls_received.load(), stats.statuses_received.load()};
+}
+
+void print_latency(char const* name, fgloadgen::LatencyHistogram const& histogram) {
+    if (histogram.count() == 0) {
+        return;
+    }
+    std::printf("  %-14s p50 %9s  p99 %9s  p99.9 %9s  max %9s  (n=%llu)\n", name,
+        fgloadgen::format_duration(histogram.quantile(0.50)).c_str(),
+        fgloadgen::format_duration(histogram.quantile(0.99)).c_str(),
+        fgloadgen::format_duration(histogram.quantile(0.999)).c_str(),
+        fgloadgen::format_duration(histogram.max()).c_str(),
+        static_cast<unsigned long long>(histogram.count()));
+}
+
+// Latency over the whole run; the live histograms only hold the current interval
+struct Totals {
+    fgloadgen::LatencyHistogram telemetry_latency;
+    fgloadgen::LatencyHistogram control_rtt;
+    fgloadgen::LatencyHistogram command_rtt;
+};
+
+void report_latency(char const* name, fgloadgen::LatencyHistogram& live, fgloadgen::LatencyHistogram& total) {
+    fgloadgen::LatencyHistogram interval;
+    live.drain_into(interval);
+    print_latency(name, interval);
+    interval.drain_into(total);
+}
+
+void report_interval(fgloadgen::Stats& stats, Totals& totals, Snapshot& previous, double seconds) {
+    auto const current = take_snapshot(stats);
+    auto const rate = [seconds](uint64_t now, uint64_t before) {
+        return static_cast<double>(now - before) / seconds;
+    };
+
+    std::printf("telemetry %9.0f tx/s %8.2f MB/s %9.0f rx/s | control %9.0f rx/s | commands %8.0f /s\n",
+        rate(current.telemetry_sent, previous.telemetry_sent),
+        rate(current.telemetry_bytes, previous.telemetry_bytes) / 1e6,
+        rate(current.telemetry_received, previous.telemetry_received),
+        rate(current.controls_received, previous.controls_received),
+        rate(current.statuses_received, previous.statuses_received));
+
+    report_latency("telemetry 1-way", stats.telemetry_latency, totals.telemetry_latency);
+    report_latency("control rtt", stats.control_rtt, totals.control_rtt);
+    report_latency("command rtt", stats.command_rtt, totals.command_rtt);
+    previous = current;
+}
+
+// Headline numbers of one run, for the profile comparison
+struct RunSummary {
+    std::string profile;
+    double telemetry_mb_per_sec = 0.0;
+    double commands_per_sec = 0.0;
+    std::chrono::nanoseconds telemetry_p50{0};
+    std::chrono::nanoseconds telemetry_p99{0};
+    std::chrono::nanoseconds control_p99{0};
+    std::chrono::nanoseconds command_p50{0};
+    std::chrono::nanoseconds command_p99{0};
+};
+
+void print_comparison(std::vector<RunSummary> const& runs) {
+    std::printf("\nsocket profile comparison\n");
+    std::printf("  %-24s %9s %10s %10s %10s %10s %10s %10s\n", "profile", "tlm MB/s", "tlm p50", "tlm p99",
+        "ctl p99", "cmd/s", "cmd p50", "cmd p99");
+    for (auto const& run : runs) {
+        std::printf("  %-24s %9.2f %10s %10s %10s %10.0f %10s %10s\n", run.profile.c_str(), run.telemetry_mb_per_sec,
+            fgloadgen::format_duration(run.telemetry_p50).c_str(),
+            fgloadgen::format_duration(run.telemetry_p99).c_str(),
+            fgloadgen::format_duration(run.control_p99).c_str(), run.commands_per_sec,
+            fgloadgen::format_duration(run.command_p50).c_str(),
+            fgloadgen::format_duration(run.command_p99).c_str());
+    }
+}
+
+// Resolve --target once, up front, so a bad host is reported instead of thrown
+std::optional<boost::asio::ip::udp::endpoint> resolve_target(fgloadgen::Target const& target) {
+    boost::asio::io_context io_context;
+    boost::asio::ip::udp::resolver resolver(io_context);
+    boost::system::error_code ec;
+    auto const results = resolver.resolve(target.host, std::to_string(target.port), ec);
+    if (ec || results.begin() == results.end()) {
+        std::fprintf(stderr, "Could not resolve %s:%d: %s\n", target.host.c_str(), target.port,
+            ec ? ec.message().c_str() : "no results");
+        return std::nullopt;
+    }
+    return results.begin()->endpoint();
+}
+
+// external_target is the resolved --target, if one was given
+RunSummary run_load(fgloadgen::Options const& options,
+    std::optional<boost::asio::ip::udp::endpoint> const& external_target) {
+    fgloadgen::Stats stats;
+    std::atomic<bool> sending{true};
+
+    // Built-in receivers run on their own thread so they don't steal time from the generators
+    boost::asio::io_context sink_context;
+    auto sink_guard = boost::asio::make_work_guard(sink_context);
+    std::optional<fgloadgen::TelemetrySink> sink;
+    std::optional<fgloadgen::CommandServer> command_server;
+
+    boost::asio::ip::udp::endpoint telemetry_target;
+    if (external_target) {
+        telemetry_target = *external_target;
+    } else if (options.instances > 0) {
+        sink.emplace(sink_context, options.socket_options, stats);
+        sink->start();
+        telemetry_target = sink->endpoint();
+    }
+
+    std::string command_target;
+    if (options.command_target) {
+        command_target = *options.command_target;
+    } else if (options.command_clients > 0) {
+        command_server.emplace(sink_context, options.command_listen, options.socket_options, stats);
+        command_server->start();
+        command_target = command_server->address();
+    }
+
+    std::thread sink_thread([&sink_context] {
+        sink_context.run();
+    });
+
+    // Generators are spread round-robin over one io_context per thread
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    for (int i = 0; i < options.threads; ++i) {
+        contexts.push_back(std::make_unique<boost::asio::io_context>());
+    }
+
+    std::vector<std::unique_ptr<fgloadgen::SimInstance>> instances;
+    for (int i = 0; i < options.instances; ++i) {
+        instances.push_back(std::make_unique<fgloadgen::SimInstance>(*contexts[i % options.threads],
+            static_cast<uint32_t>(i), options, telemetry_target, stats, sending));
+        instances.back()->start();
+    }
+
+    std::vector<std::unique_ptr<fgloadgen::CommandClient>> clients;
+    for (int i = 0; i < options.command_clients; ++i) {
+        clients.push_back(std::make_unique<fgloadgen::CommandClient>(*contexts[i % options.threads],
+            static_cast<uint32_t>(i), options, command_target, stats, sending));
+        clients.back()->start();
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& context : contexts) {
+        threads.emplace_back([&context] {
+            auto guard = boost::asio::make_work_guard(*context);
+            context->run();
+        });
+    }
+
+    std::printf("fgloadgen: %d instance(s) at %.0f Hz, %d command client(s), %d thread(s), %.0f s\n",
+        options.instances, options.telemetry_rate, options.command_clients, options.threads, options.duration);
+    std::printf("socket profile %s (%s)\n", options.socket_options.name.c_str(),
+        options.socket_options.describe().c_str());
+
+    Totals totals;
+    Snapshot previous;
+    auto const begin = Clock::now();
+    auto const end = begin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+    auto const interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.report_interval));
+    auto last_report = begin;
+    while (Clock::now() < end) {
+        std::this_thread::sleep_until(std::min(last_report + interval, end));
+        auto const now = Clock::now();
+        report_interval(stats, totals, previous, std::chrono::duration<double>(now - last_report).count());
+        last_report = now;
+    }
+
+    // Stop generating, then give in-flight replies a moment before tearing down
+    sending.store(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    for (auto& context : contexts) {
+        context->stop();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    sink_context.stop();
+    sink_thread.join();
+
+    auto const elapsed = std::chrono::duration<double>(last_report - begin).count();
+    auto const sent = stats.telemetry_sent.load();
+    auto const received = stats.telemetry_received.load();
+
+    // Replies that arrived during the drain period
+    report_interval(stats, totals, previous, std::chrono::duration<double>(Clock::now() - last_report).count());
+
+    std::printf("\nsummary over %.1f s\n", elapsed);
+    std::printf("  telemetry      %llu sent (%.0f/s, %.2f MB/s)\n", static_cast<unsigned long long>(sent),
+        static_cast<double>(sent) / elapsed, static_cast<double>(stats.telemetry_bytes.load()) / elapsed / 1e6);
+    if (sink) {
+        std::printf("  built-in rx    %llu received, %llu gaps, loss %.3f%%\n",
+            static_cast<unsigned long long>(received), static_cast<unsigned long long>(stats.telemetry_lost.load()),
+            sent ? 100.0 * static_cast<double>(sent - std::min(sent, received)) / static_cast<double>(sent) : 0.0);
+    }
+    std::printf("  control        %llu received, %llu invalid\n",
+        static_cast<unsigned long long>(stats.controls_received.load()),
+        static_cast<unsigned long long>(stats.controls_invalid.load()));
+    if (options.command_clients > 0) {
+        std::printf("  commands       %llu sent, %llu answered (%.0f/s), %llu failures\n",
+            static_cast<unsigned long long>(stats.commands_sent.load()),
+            static_cast<unsigned long long>(stats.statuses_received.load()),
+            static_cast<double>(stats.statuses_received.load()) / elapsed,
+            static_cast<unsigned long long>(stats.command_failures.load()));
+    }
+    print_latency("telemetry 1-way", totals.telemetry_latency);
+    print_latency("control rtt", totals.control_rtt);
+    print_latency("command rtt", totals.command_rtt);
+
+    RunSummary summary;
+    summary.profile = options.socket_options.name;
+    summary.telemetry_mb_per_sec = static_cast<double>(stats.telemetry_bytes.load()) / elapsed / 1e6;
+    summary.commands_per_sec = static_cast<double>(stats.statuses_received.load()) / elapsed;
+    summary.telemetry_p50 = totals.telemetry_latency.quantile(0.50);
+    summary.telemetry_p99 = totals.telemetry_latency.quantile(0.99);
+    summary.control_p99 = totals.control_rtt.quantile(0.99);
+    summary.command_p50 = totals.command_rtt.quantile(0.50);
+    summary.command_p99 = totals.command_rtt.quantile(0.99);
+    return summary;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    auto options = fgloadgen::parse_options(argc, argv);
+    if (!options) {
+        return 1;
+    }
+
+    std::optional<boost::asio::ip::udp::endpoint> telemetry_target;
+    if (options->telemetry_target) {
+        telemetry_target = resolve_target(*options->telemetry_target);
+        if (!telemetry_target) {
+            return 1;
+        }
+    }
+
+    std::vector<RunSummary> runs;
+    for (auto const& profile : options->socket_profiles) {
+        if (!runs.empty()) {
+            std::printf("\n");
+        }
+        options->socket_options = profile;
+        runs.push_back(run_load(*options, telemetry_target));
+    }
+    if (runs.size() > 1) {
+        print_comparison(runs);
+    }
+    return 0;
+}
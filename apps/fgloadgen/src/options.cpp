@@ -0,0 +1,116 @@
+#include "fgloadgen/options.hpp"
+#include <iostream>
+#include <string_view>
+#include "network/address.hpp"
+
+namespace fgloadgen {
+namespace {
+void print_usage(char const* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --instances=N        emulated FlightGear instances (default 1)\n"
+              << "  --rate=HZ            telemetry frames per second per instance (default 60)\n"
+              << "  --size=BYTES         pad telemetry datagrams to BYTES\n"
+              << "  --target=HOST:PORT   send telemetry to an external receiver instead of the built-in one\n"
+              << "  --command-clients=N  TCP clients sending Command messages (default 0)\n"
+              << "  --command-rate=HZ    commands per second per client (default 0 = closed loop)\n"
+              << "  --command-target=ADDRESS  external command server instead of the built-in one:\n"
+              << "                       HOST:PORT, unix:/PATH or @ABSTRACT-NAME\n"
+              << "  --command-listen=ADDRESS  address of the built-in command server (default 127.0.0.1:0)\n"
+              << "  --socket-profile=SPEC  socket options: default, low-latency, bulk, and/or overrides\n"
+              << "                       such as nodelay=1,rcvbuf=262144,sndbuf=N,busy_poll=50,quickack=1,tos=0xB8;\n"
+              << "                       repeat to sweep several profiles and compare them\n"
+              << "  --threads=N          I/O threads for the emulated instances (default 1)\n"
+              << "  --duration=SEC       run time (default 10)\n"
+              << "  --report=SEC         report interval (default 1)\n";
+}
+
+std::optional<Target> parse_target(std::string_view value) {
+    auto const colon = value.rfind(':');
+    if (colon == std::string_view::npos || colon == 0) {
+        return std::nullopt;
+    }
+    return Target{std::string(value.substr(0, colon)), std::stoi(std::string(value.substr(colon + 1)))};
+}
+
+// unix:/path, @name or host:port; a server may also listen on a bare port
+bool valid_stream_address(std::string_view value, bool listening) {
+    if (network::is_local_address(value)) {
+        return network::parse_local_address<boost::asio::local::stream_protocol>(value).has_value();
+    }
+    auto const host_port = network::parse_host_port(value);
+    return host_port && (listening || !host_port->host.empty());
+}
+} // namespace
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+    Options options;
+    std::vector<network::SocketOptions> profiles;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg(argv[i]);
+        auto const eq = arg.find('=');
+        auto const key = arg.substr(0, eq);
+        auto const value = eq == std::string_view::npos ? std::string() : std::string(arg.substr(eq + 1));
+
+        try {
+            if (key == "--instances") {
+                options.instances = std::stoi(value);
+            } else if (key == "--rate") {
+                options.telemetry_rate = std::stod(value);
+            } else if (key == "--size") {
+                options.datagram_size = std::stoul(value);
+            } else if (key == "--target") {
+                options.telemetry_target = parse_target(value);
+                if (!options.telemetry_target) {
+                    throw std::invalid_argument(value);
+                }
+            } else if (key == "--command-clients") {
+                options.command_clients = std::stoi(value);
+            } else if (key == "--command-rate") {
+                options.command_rate = std::stod(value);
+            } else if (key == "--command-target") {
+                if (!valid_stream_address(value, false)) {
+                    throw std::invalid_argument(value);
+                }
+                options.command_target = value;
+            } else if (key == "--command-listen") {
+                if (!valid_stream_address(value, true)) {
+                    throw std::invalid_argument(value);
+                }
+                options.command_listen = value;
+            } else if (key == "--socket-profile") {
+                auto profile = network::SocketOptions::parse(value);
+                if (!profile) {
+                    throw std::invalid_argument(value);
+                }
+                profiles.push_back(std::move(*profile));
+            } else if (key == "--threads") {
+                options.threads = std::stoi(value);
+            } else if (key == "--duration") {
+                options.duration = std::stod(value);
+            } else if (key == "--report") {
+                options.report_interval = std::stod(value);
+            } else {
+                print_usage(argv[0]);
+                return std::nullopt;
+            }
+        } catch (std::exception const&) {
+            std::cerr << "Invalid value for " << key << ": '" << value << "'\n";
+            print_usage(argv[0]);
+            return std::nullopt;
+        }
+    }
+
+    if (!profiles.empty()) {
+        options.socket_profiles = std::move(profiles);
+    }
+    options.socket_options = options.socket_profiles.front();
+
+    if (options.instances < 0 || options.command_clients < 0 || options.threads < 1
+        || options.telemetry_rate <= 0.0 || options.duration <= 0.0 || options.report_interval <= 0.0) {
+        print_usage(argv[0]);
+        return std::nullopt;
+    }
+    return options;
+}
+} // namespace fgloadgen
@@ -0,0 +1,100 @@
+#include "fgloadgen/sim_instance.hpp"
+#include "fgloadgen/probe.hpp"
+
+namespace fgloadgen {
+namespace {
+// Upper bound on frames sent back-to-back when the timer fell behind
+constexpr int MAX_CATCH_UP_FRAMES = 16;
+} // namespace
+
+SimInstance::SimInstance(boost::asio::io_context& io_context, uint32_t id, Options const& options,
+    boost::asio::ip::udp::endpoint const& target, Stats& stats, std::atomic<bool> const& sending)
+    : udp_client_(io_context, 0, options.socket_options),
+      timer_(io_context),
+      id_(id),
+      datagram_size_(options.datagram_size),
+      period_(std::chrono::nanoseconds(static_cast<int64_t>(1e9 / options.telemetry_rate))),
+      model_(id),
+      sequence_(0),
+      stats_(stats),
+      sending_(sending) {
+    udp_client_.set_message_handler(
+        [this](uint8_t const* data, std::size_t length, boost::asio::ip::udp::endpoint const& /*sender*/) {
+            this->handle_control(data, length);
+        });
+    // Connected mode: the target never changes, so skip per-packet addressing
+    udp_client_.connect(target);
+}
+
+void SimInstance::start() {
+    udp_client_.start();
+    next_tick_ = std::chrono::steady_clock::now();
+    schedule_tick();
+}
+
+void SimInstance::stop() {
+    timer_.cancel();
+    udp_client_.stop();
+}
+
+void SimInstance::schedule_tick() {
+    next_tick_ += period_;
+    timer_.expires_at(next_tick_);
+    timer_.async_wait([this](boost::system::error_code const& error) {
+        if (!error) {
+            this->tick();
+        }
+    });
+}
+
+void SimInstance::tick() {
+    if (!sending_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Send every frame that is due, but don't burst without limit after a stall
+    auto const now = std::chrono::steady_clock::now();
+    int frames = 1;
+    while (next_tick_ + period_ <= now && frames < MAX_CATCH_UP_FRAMES) {
+        next_tick_ += period_;
+        ++frames;
+    }
+    if (next_tick_ + period_ <= now) {
+        next_tick_ = now;
+    }
+    double const dt = std::chrono::duration<double>(period_).count();
+    for (int i = 0; i < frames; ++i) {
+        send_frame(dt);
+    }
+    schedule_tick();
+}
+
+void SimInstance::send_frame(double dt) {
+    model_.step(dt);
+
+    auto telemetry = model_.telemetry();
+    telemetry.vehicle_id = id_;
+    auto datagram = protocol::TelemetryMessage::create(telemetry);
+    append_probe(datagram, ProbeTrailer{ProbeTrailer::MAGIC, id_, ++sequence_, steady_now_ns()}, datagram_size_);
+
+    // The send owns the datagram until it completes, however far the socket backs up
+    stats_.telemetry_sent.fetch_add(1, std::memory_order_relaxed);
+    stats_.telemetry_bytes.fetch_add(datagram.size(), std::memory_order_relaxed);
+    udp_client_.send(std::move(datagram));
+}
+
+void SimInstance::handle_control(uint8_t const* data, std::size_t length) {
+    protocol::ControlMessage::Control control{};
+    if (!protocol::ControlMessage::parse(data, length, control) || control.vehicle_id != id_) {
+        stats_.controls_invalid.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    model_.apply(control);
+    stats_.controls_received.fetch_add(1, std::memory_order_relaxed);
+
+    // Replies from the built-in receiver echo our probe
+    if (auto const probe = find_probe(data, length); probe && probe->instance == id_) {
+        stats_.control_rtt.record(std::chrono::nanoseconds(steady_now_ns() - probe->send_time_ns));
+    }
+}
+} // namespace fgloadgen
@@ -0,0 +1,87 @@
+#include "fgloadgen/stats.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+namespace fgloadgen {
+std::size_t LatencyHistogram::index_of(uint64_t value) {
+    if (value < (1U << SUB_BUCKET_BITS)) {
+        return static_cast<std::size_t>(value);
+    }
+    auto const msb = 63 - std::countl_zero(value);
+    auto const shift = msb - SUB_BUCKET_BITS;
+    auto const sub = (value >> shift) & ((1U << SUB_BUCKET_BITS) - 1);
+    return (static_cast<std::size_t>(shift + 1) << SUB_BUCKET_BITS) + sub;
+}
+
+uint64_t LatencyHistogram::value_of(std::size_t index) {
+    auto const group = index >> SUB_BUCKET_BITS;
+    auto const sub = index & ((1U << SUB_BUCKET_BITS) - 1);
+    if (group == 0) {
+        return sub;
+    }
+    auto const shift = group - 1;
+    // Upper edge of the bucket, so percentiles never under-report
+    return (((1ULL << SUB_BUCKET_BITS) | sub) << shift) + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    auto const value = static_cast<uint64_t>(std::max<int64_t>(0, latency.count()));
+    buckets_[index_of(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    auto current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::chrono::nanoseconds LatencyHistogram::quantile(double q) const {
+    auto const total = count();
+    if (total == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    auto const rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(std::min(value_of(i), max_.load(std::memory_order_relaxed)));
+        }
+    }
+    return max();
+}
+
+std::chrono::nanoseconds LatencyHistogram::max() const {
+    return std::chrono::nanoseconds(max_.load(std::memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::count() const {
+    return count_.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::drain_into(LatencyHistogram& other) {
+    for (std::size_t i = 0; i < buckets_.size(); ++i) {
+        auto const n = buckets_[i].exchange(0, std::memory_order_relaxed);
+        other.buckets_[i].fetch_add(n, std::memory_order_relaxed);
+        other.count_.fetch_add(n, std::memory_order_relaxed);
+        count_.fetch_sub(n, std::memory_order_relaxed);
+    }
+    auto const max = max_.exchange(0, std::memory_order_relaxed);
+    auto current = other.max_.load(std::memory_order_relaxed);
+    while (max > current && !other.max_.compare_exchange_weak(current, max, std::memory_order_relaxed)) {
+    }
+}
+
+std::string format_duration(std::chrono::nanoseconds value) {
+    std::array<char, 32> buf{};
+    auto const ns = static_cast<double>(value.count());
+    if (ns < 1e3) {
+        std::snprintf(buf.data(), buf.size(), "%.0fns", ns);
+    } else if (ns < 1e6) {
+        std::snprintf(buf.data(), buf.size(), "%.1fus", ns / 1e3);
+    } else {
+        std::snprintf(buf.data(), buf.size(), "%.2fms", ns / 1e6);
+    }
+    return buf.data();
+}
+} // namespace fgloadgen
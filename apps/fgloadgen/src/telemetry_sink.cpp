@@ -0,0 +1,69 @@
+#include "fgloadgen/telemetry_sink.hpp"
+#include "fgloadgen/probe.hpp"
+#include "protocol/messages.hpp"
+#include <algorithm>
+
+namespace fgloadgen {
+namespace {
+constexpr double HOLD_ALTITUDE_FT = 500.0;
+} // namespace
+
+TelemetrySink::TelemetrySink(boost::asio::io_context& io_context, network::SocketOptions const& socket_options,
+    Stats& stats)
+    : udp_client_(io_context, 0, socket_options),
+      stats_(stats) {
+    udp_client_.set_message_handler(
+        [this](uint8_t const* data, std::size_t length, boost::asio::ip::udp::endpoint const& sender) {
+            this->handle_telemetry(data, length, sender);
+        });
+}
+
+void TelemetrySink::start() {
+    udp_client_.start();
+}
+
+void TelemetrySink::stop() {
+    udp_client_.stop();
+}
+
+boost::asio::ip::udp::endpoint TelemetrySink::endpoint() const {
+    return {boost::asio::ip::address_v4::loopback(), static_cast<unsigned short>(udp_client_.get_local_port())};
+}
+
+void TelemetrySink::handle_telemetry(uint8_t const* data, std::size_t length,
+    boost::asio::ip::udp::endpoint const& sender) {
+    protocol::TelemetryMessage::Telemetry telemetry{};
+    if (!protocol::TelemetryMessage::parse(data, length, telemetry)) {
+        return;
+    }
+    stats_.telemetry_received.fetch_add(1, std::memory_order_relaxed);
+
+    auto const probe = find_probe(data, length);
+    if (probe) {
+        stats_.telemetry_latency.record(std::chrono::nanoseconds(steady_now_ns() - probe->send_time_ns));
+
+        // Count sequence gaps; late (reordered) frames are not subtracted again
+        auto& last = last_sequence_[probe->instance];
+        if (probe->sequence > last + 1) {
+            stats_.telemetry_lost.fetch_add(probe->sequence - last - 1, std::memory_order_relaxed);
+        }
+        last = std::max(last, probe->sequence);
+    }
+
+    // Altitude hold with wings level
+    protocol::ControlMessage::Control control{};
+    control.collective = static_cast<float>(std::clamp(
+        0.5 + 0.002 * (HOLD_ALTITUDE_FT - telemetry.altitude) - 0.0002 * telemetry.vertical_speed, 0.0, 1.0));
+    control.cyclic_lat = std::clamp(-telemetry.roll / 30.0F, -1.0F, 1.0F);
+    control.cyclic_lon = std::clamp(telemetry.pitch / 20.0F, -1.0F, 1.0F);
+    control.pedals = 0.0F;
+    control.timestamp = telemetry.timestamp;
+    control.vehicle_id = telemetry.vehicle_id;
+
+    auto reply = protocol::ControlMessage::create(control);
+    if (probe) {
+        append_probe(reply, *probe);
+    }
+    udp_client_.send_data(std::move(reply), sender);
+}
+} // namespace fgloadgen
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <boost/asio.hpp>
+#include "network/udp_client.hpp"
+#include "protocol/messages.hpp"
+
+namespace hoverlink {
+struct ControlOutputOptions {
+    // Flush cadence; FlightGear consumes inputs once per sim frame
+    double frame_rate = 60.0;
+
+    // Send immediately, without waiting for the next flush, when any axis moved
+    // by more than this since the last command sent to the target
+    float immediate_threshold = 0.1F;
+};
+
+// Latest-value-wins output stage for control commands.
+//
+// Keeps only the newest command per vehicle and sends it on a fixed cadence,
+// so bursts from the control law don't turn into a queue of stale commands in
+// FlightGear's input socket. Large changes bypass the cadence. Runs entirely
+// on the io_context thread; producers on other threads post submit() there.
+// Commands are encoded only when they go out, so a superseded one costs a
+// struct copy, not an encode.
+class ControlOutput {
+public:
+    using Control = protocol::ControlMessage::Control;
+
+    // Throws std::invalid_argument unless options.frame_rate is positive
+    ControlOutput(boost::asio::io_context& io_context, network::UDPClient& udp_client,
+                  ControlOutputOptions const& options = {});
+
+    void start();
+
+    // Flushes anything pending, then stops the cadence timer
+    void stop();
+
+    // Replace the pending command for control.vehicle_id. Dropped while
+    // stopped. io_context thread only.
+    void submit(Control const& control, boost::asio::ip::udp::endpoint const& target);
+
+    // Counters
+    [[nodiscard]] uint64_t submitted() const;
+    [[nodiscard]] uint64_t coalesced() const; // Overwritten before they were sent
+    [[nodiscard]] uint64_t sent() const;
+    [[nodiscard]] uint64_t sent_immediately() const;
+    [[nodiscard]] uint64_t dropped() const; // Submitted while stopped
+
+private:
+    struct Target {
+        boost::asio::ip::udp::endpoint endpoint;
+        Control pending{};
+        Control last_sent{};
+        bool dirty = false;
+        bool has_sent = false;
+    };
+
+    void schedule_flush();
+    void flush();
+    void send(Target& target);
+    [[nodiscard]] bool exceeds_threshold(Target const& target, Control const& control) const;
+
+    network::UDPClient& udp_client_;
+    boost::asio::steady_timer timer_;
+    std::chrono::steady_clock::duration period_;
+    std::chrono::steady_clock::time_point next_flush_;
+    float immediate_threshold_;
+    bool running_;
+    std::unordered_map<uint32_t, Target> targets_;
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> coalesced_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> sent_immediately_;
+    std::atomic<uint64_t> dropped_;
+};
+} // namespace hoverlink
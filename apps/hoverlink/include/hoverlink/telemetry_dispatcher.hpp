@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <boost/asio.hpp>
+#include "concurrency/spsc_queue.hpp"
+#include "hoverlink/vehicle_state.hpp"
+#include "protocol/messages.hpp"
+
+namespace hoverlink {
+// Unit of work queued to a shard
+struct TelemetryFrame {
+    protocol::TelemetryMessage::Telemetry telemetry{};
+    boost::asio::ip::udp::endpoint source;
+    std::chrono::steady_clock::time_point received{};
+};
+
+// Fans telemetry out to N worker shards by vehicle id.
+//
+// The I/O thread is the single producer for every shard queue; each shard has
+// one worker thread that owns the state and control loop of its vehicles. A
+// vehicle always hashes to the same shard, and shard queues are FIFO, so
+// per-vehicle frame order is preserved.
+class TelemetryDispatcher {
+public:
+    using Telemetry = protocol::TelemetryMessage::Telemetry;
+    using Control = protocol::ControlMessage::Control;
+
+    // Runs on the shard thread for every frame, after the vehicle state (and
+    // its prediction to the current time) is updated
+    using ControlLaw = std::function<std::optional<Control>(VehicleState&)>;
+
+    // Receives the commands produced by the control law, on the shard thread
+    using ControlSink = std::function<void(Control const&, boost::asio::ip::udp::endpoint const&)>;
+
+    static constexpr std::size_t QUEUE_CAPACITY = 1024;
+
+    TelemetryDispatcher(std::size_t shard_count, ControlLaw control_law, ControlSink control_sink);
+    ~TelemetryDispatcher();
+
+    TelemetryDispatcher(TelemetryDispatcher const&) = delete;
+    TelemetryDispatcher& operator=(TelemetryDispatcher const&) = delete;
+
+    // Start / stop the shard threads
+    void start();
+    void stop();
+
+    // Hand a frame to its vehicle's shard. Producer side: call from one thread
+    // only. Returns false (and counts a drop) if the shard is not keeping up.
+    bool dispatch(Telemetry const& telemetry, boost::asio::ip::udp::endpoint const& source);
+
+    // Shard a vehicle is pinned to
+    [[nodiscard]] std::size_t shard_of(uint32_t vehicle_id) const;
+    [[nodiscard]] std::size_t shard_count() const;
+
+    // Counters
+    [[nodiscard]] uint64_t frames_dispatched() const;
+    [[nodiscard]] uint64_t frames_dropped() const;
+    [[nodiscard]] uint64_t frames_stale() const; // Not newer than the vehicle's latest, used as-is
+    [[nodiscard]] std::size_t vehicle_count() const;
+
+private:
+    struct Shard {
+        concurrency::SPSCQueue<TelemetryFrame, QUEUE_CAPACITY> queue;
+        alignas(concurrency::CACHE_LINE_SIZE) std::atomic<uint32_t> wakeups{0};
+        std::atomic<std::size_t> vehicles{0};
+        std::unordered_map<uint32_t, VehicleState> states; // Worker thread only
+        std::thread worker;
+    };
+
+    void run_shard(Shard& shard);
+    void process(Shard& shard, TelemetryFrame const& frame);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    ControlLaw control_law_;
+    ControlSink control_sink_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> frames_dispatched_;
+    std::atomic<uint64_t> frames_dropped_;
+    std::atomic<uint64_t> frames_stale_;
+};
+} // namespace hoverlink
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <boost/asio.hpp>
+#include "concurrency/seqlock.hpp"
+#include "network/udp_client.hpp"
+#include "protocol/messages.hpp"
+
+namespace hoverlink {
+class TelemetryDispatcher;
+
+// Receives HelicopterTelemetry from FlightGear and publishes the most recent
+// frame into a seqlock snapshot that any thread can read without locking.
+// With a dispatcher attached, every frame is also handed to its vehicle's shard.
+class TelemetryReceiver {
+public:
+    using Telemetry = protocol::TelemetryMessage::Telemetry;
+
+    explicit TelemetryReceiver(boost::asio::io_context& io_context, int port = network::DEFAULT_UDP_PORT,
+                               network::SocketOptions const& socket_options = {});
+
+    // Start receiving telemetry
+    void start();
+
+    // Stop receiving telemetry
+    void stop();
+
+    // Route frames to per-vehicle shards (nullptr to detach). Set before start().
+    void set_dispatcher(TelemetryDispatcher* dispatcher);
+
+    // Socket shared with the control output path (replies go back from the telemetry port)
+    [[nodiscard]] network::UDPClient& udp_client();
+
+    // Latest telemetry frame from any vehicle, safe to read from any thread
+    [[nodiscard]] concurrency::SeqlockSnapshot<Telemetry> const& latest() const;
+
+    // Counters
+    [[nodiscard]] uint64_t frames_received() const;
+    [[nodiscard]] uint64_t frames_rejected() const;
+
+    // Time the latest frame spent between kernel arrival and our handler
+    [[nodiscard]] std::chrono::nanoseconds last_queue_latency() const;
+
+private:
+    void handle_datagram(uint8_t const* data, std::size_t length, boost::asio::ip::udp::endpoint const& sender);
+    void handle_telemetry(Telemetry const& telemetry, boost::asio::ip::udp::endpoint const& sender);
+
+    network::UDPClient udp_client_;
+    TelemetryDispatcher* dispatcher_;
+    concurrency::SeqlockSnapshot<Telemetry> latest_;
+    std::atomic<uint64_t> frames_received_;
+    std::atomic<uint64_t> frames_rejected_;
+    std::atomic<int64_t> last_queue_latency_ns_;
+};
+} // namespace hoverlink
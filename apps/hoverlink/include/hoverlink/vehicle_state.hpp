@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <boost/asio.hpp>
+#include "protocol/messages.hpp"
+#include "protocol/predictor.hpp"
+
+namespace hoverlink {
+// Per-vehicle state owned by exactly one dispatcher shard
+struct VehicleState {
+    uint32_t vehicle_id = 0;
+    boost::asio::ip::udp::endpoint source; // Where this vehicle's telemetry comes from
+    protocol::TelemetryMessage::Telemetry latest{};
+    uint64_t frames = 0;
+
+    // Dead reckoning from recent frames; predicted is the state extrapolated
+    // to when the control law runs
+    protocol::TelemetryPredictor predictor;
+    protocol::TelemetryMessage::Telemetry predicted{};
+
+    // How far off the prediction for the newest frame was (the predictor
+    // keeps the running RMS), and frames the predictor refused because they
+    // were not newer than what it already had
+    std::optional<protocol::PredictionError> prediction_error;
+    uint64_t stale_frames = 0;
+
+    // Control law state
+    bool holding = false;
+    double hold_altitude = 0.0;
+    float hold_heading = 0.0F;
+};
+
+// Hover hold: keep the altitude and heading the vehicle had when first seen,
+// wings level, no forward speed. Returns the command to send, if any.
+std::optional<protocol::ControlMessage::Control> hover_hold(VehicleState& vehicle);
+} // namespace hoverlink
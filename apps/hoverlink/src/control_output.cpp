@@ -0,0 +1,135 @@
+#include "hoverlink/control_output.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace hoverlink {
+namespace {
+std::chrono::steady_clock::duration frame_period(double frame_rate) {
+    if (!(frame_rate > 0.0)) {
+        throw std::invalid_argument("Control output frame rate must be positive");
+    }
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / frame_rate));
+}
+} // namespace
+
+ControlOutput::ControlOutput(boost::asio::io_context& io_context, network::UDPClient& udp_client,
+    ControlOutputOptions const& options)
+    : udp_client_(udp_client),
+      timer_(io_context),
+      period_(frame_period(options.frame_rate)),
+      immediate_threshold_(options.immediate_threshold),
+      running_(false),
+      submitted_(0),
+      coalesced_(0),
+      sent_(0),
+      sent_immediately_(0),
+      dropped_(0) {
+}
+
+void ControlOutput::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    next_flush_ = std::chrono::steady_clock::now();
+    schedule_flush();
+}
+
+void ControlOutput::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    timer_.cancel();
+    flush();
+}
+
+void ControlOutput::submit(Control const& control, boost::asio::ip::udp::endpoint const& target_endpoint) {
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    if (!running_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& target = targets_[control.vehicle_id];
+    target.endpoint = target_endpoint;
+    if (target.dirty) {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+    target.pending = control;
+    target.dirty = true;
+
+    // Big moves (or nothing sent yet) shouldn't wait for the next frame
+    if (exceeds_threshold(target, control)) {
+        send(target);
+        sent_immediately_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t ControlOutput::submitted() const {
+    return submitted_.load(std::memory_order_relaxed);
+}
+
+uint64_t ControlOutput::coalesced() const {
+    return coalesced_.load(std::memory_order_relaxed);
+}
+
+uint64_t ControlOutput::sent() const {
+    return sent_.load(std::memory_order_relaxed);
+}
+
+uint64_t ControlOutput::sent_immediately() const {
+    return sent_immediately_.load(std::memory_order_relaxed);
+}
+
+uint64_t ControlOutput::dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void ControlOutput::schedule_flush() {
+    // Absolute deadlines keep the cadence from drifting with handler latency
+    next_flush_ += period_;
+    auto const now = std::chrono::steady_clock::now();
+    if (next_flush_ < now) {
+        next_flush_ = now;
+    }
+    timer_.expires_at(next_flush_);
+    timer_.async_wait([this](boost::system::error_code const& error) {
+        if (error || !running_) {
+            return;
+        }
+        flush();
+        schedule_flush();
+    });
+}
+
+void ControlOutput::flush() {
+    for (auto& [vehicle_id, target] : targets_) {
+        if (target.dirty) {
+            send(target);
+        }
+    }
+}
+
+void ControlOutput::send(Target& target) {
+    udp_client_.send_data(protocol::ControlMessage::create(target.pending), target.endpoint);
+    target.last_sent = target.pending;
+    target.has_sent = true;
+    target.dirty = false;
+    sent_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ControlOutput::exceeds_threshold(Target const& target, Control const& control) const {
+    if (!target.has_sent) {
+        return true;
+    }
+    auto const& last = target.last_sent;
+    auto const delta = std::max({std::abs(control.collective - last.collective),
+                                 std::abs(control.cyclic_lat - last.cyclic_lat),
+                                 std::abs(control.cyclic_lon - last.cyclic_lon),
+                                 std::abs(control.pedals - last.pedals)});
+    return delta > immediate_threshold_;
+}
+} // namespace hoverlink
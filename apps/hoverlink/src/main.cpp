@@ -1,5 +1,90 @@
+#include "hoverlink/control_output.hpp"
+#include "hoverlink/telemetry_dispatcher.hpp"
+#include "hoverlink/telemetry_receiver.hpp"
+#include "hoverlink/vehicle_state.hpp"
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <boost/asio.hpp>
 
 int main(int argc, char *argv[])
 {
+    int const telemetry_port = argc > 1 ? std::atoi(argv[1]) : network::DEFAULT_UDP_PORT;
+
+    // One shard per core, leaving one for the I/O thread. hardware_concurrency()
+    // may report 0 when it can't tell.
+    auto const cores = std::thread::hardware_concurrency();
+    std::size_t shards = cores <= 1 ? 1 : cores - 1;
+    if (argc > 2) {
+        std::string_view const text = argv[2];
+        int value = 0;
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error == std::errc() && end == text.data() + text.size() && value > 0) {
+            shards = static_cast<std::size_t>(value);
+        } else {
+            network::log_error("Invalid shard count '" + std::string(text) + "', using " + std::to_string(shards));
+        }
+    }
+
+    // Socket profile spec, see network::SocketOptions::parse
+    auto const socket_options = network::SocketOptions::parse(argc > 3 ? argv[3] : "low-latency");
+    if (!socket_options) {
+        network::log_error(std::string("Invalid socket profile: ") + argv[3]);
+        return 1;
+    }
+
+    boost::asio::io_context io_context;
+    hoverlink::TelemetryReceiver telemetry(io_context, telemetry_port, *socket_options);
+
+    // Only the newest command per vehicle goes out, once per sim frame
+    hoverlink::ControlOutput control_output(io_context, telemetry.udp_client());
+
+    // Control loops run on the shard threads; the I/O thread keeps the newest
+    // command per vehicle and encodes only the ones it sends
+    hoverlink::TelemetryDispatcher dispatcher(shards, hoverlink::hover_hold,
+        [&io_context, &control_output](protocol::ControlMessage::Control const& control,
+                                       boost::asio::ip::udp::endpoint const& vehicle) {
+            boost::asio::post(io_context, [&control_output, control, vehicle] {
+                control_output.submit(control, vehicle);
+            });
+        });
+    telemetry.set_dispatcher(&dispatcher);
+    dispatcher.start();
+    control_output.start();
+    telemetry.start();
+
+    boost::asio::signal_set signals(io_context, SIGINT, SIGTERM);
+    signals.async_wait([&](boost::system::error_code const&, int) {
+        control_output.stop();
+        telemetry.stop();
+        io_context.stop();
+    });
+
+    // Network I/O runs on its own thread; consumers only touch the snapshot
+    std::thread io_thread([&io_context] {
+        io_context.run();
+    });
+
+    while (!io_context.stopped()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (telemetry.latest().version() == 0) {
+            continue;
+        }
+        auto const state = telemetry.latest().load();
+        network::log_info("vehicles " + std::to_string(dispatcher.vehicle_count()) +
+                          ", last alt " + std::to_string(state.altitude) + " ft" +
+                          ", frames " + std::to_string(telemetry.frames_received()) +
+                          ", dropped " + std::to_string(dispatcher.frames_dropped()) +
+                          " stale " + std::to_string(dispatcher.frames_stale()) +
+                          ", controls sent " + std::to_string(control_output.sent()) +
+                          " coalesced " + std::to_string(control_output.coalesced()) +
+                          ", queue latency " + std::to_string(telemetry.last_queue_latency().count()) + " ns");
+    }
+
+    io_thread.join();
+    dispatcher.stop();
     return 0;
 }
@@ -0,0 +1,160 @@
+#include "hoverlink/telemetry_dispatcher.hpp"
+#include "network/common.hpp"
+
+namespace hoverlink {
+namespace {
+// Polls before a worker parks on its wakeup counter
+constexpr int SPIN_LIMIT = 256;
+
+// Vehicle ids are small and often sequential; mix them so shards stay balanced
+uint32_t mix(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+} // namespace
+
+TelemetryDispatcher::TelemetryDispatcher(std::size_t shard_count, ControlLaw control_law, ControlSink control_sink)
+    : control_law_(std::move(control_law)),
+      control_sink_(std::move(control_sink)),
+      running_(false),
+      frames_dispatched_(0),
+      frames_dropped_(0),
+      frames_stale_(0) {
+    for (std::size_t i = 0; i < std::max<std::size_t>(1, shard_count); ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+TelemetryDispatcher::~TelemetryDispatcher() {
+    stop();
+}
+
+void TelemetryDispatcher::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    for (auto& shard : shards_) {
+        shard->worker = std::thread([this, &shard = *shard] {
+            run_shard(shard);
+        });
+    }
+    network::log_info("Telemetry dispatcher started with " + std::to_string(shards_.size()) + " shards");
+}
+
+void TelemetryDispatcher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    for (auto& shard : shards_) {
+        shard->wakeups.fetch_add(1, std::memory_order_release);
+        shard->wakeups.notify_one();
+    }
+    for (auto& shard : shards_) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+}
+
+bool TelemetryDispatcher::dispatch(Telemetry const& telemetry, boost::asio::ip::udp::endpoint const& source) {
+    auto& shard = *shards_[shard_of(telemetry.vehicle_id)];
+    if (!shard.queue.try_push(TelemetryFrame{telemetry, source, std::chrono::steady_clock::now()})) {
+        frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    frames_dispatched_.fetch_add(1, std::memory_order_relaxed);
+
+    // Only costs a futex wake when the worker is actually parked
+    shard.wakeups.fetch_add(1, std::memory_order_release);
+    shard.wakeups.notify_one();
+    return true;
+}
+
+std::size_t TelemetryDispatcher::shard_of(uint32_t vehicle_id) const {
+    return mix(vehicle_id) % shards_.size();
+}
+
+std::size_t TelemetryDispatcher::shard_count() const {
+    return shards_.size();
+}
+
+uint64_t TelemetryDispatcher::frames_dispatched() const {
+    return frames_dispatched_.load(std::memory_order_relaxed);
+}
+
+uint64_t TelemetryDispatcher::frames_dropped() const {
+    return frames_dropped_.load(std::memory_order_relaxed);
+}
+
+uint64_t TelemetryDispatcher::frames_stale() const {
+    return frames_stale_.load(std::memory_order_relaxed);
+}
+
+std::size_t TelemetryDispatcher::vehicle_count() const {
+    std::size_t count = 0;
+    for (auto const& shard : shards_) {
+        count += shard->vehicles.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void TelemetryDispatcher::run_shard(Shard& shard) {
+    int idle = 0;
+    while (running_.load(std::memory_order_acquire)) {
+        auto const seen = shard.wakeups.load(std::memory_order_acquire);
+        if (auto frame = shard.queue.try_pop()) {
+            process(shard, *frame);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPIN_LIMIT) {
+            concurrency::cpu_relax();
+            continue;
+        }
+        // Park until the producer bumps the counter past what we saw before the empty check
+        shard.wakeups.wait(seen, std::memory_order_acquire);
+        idle = 0;
+    }
+}
+
+void TelemetryDispatcher::process(Shard& shard, TelemetryFrame const& frame) {
+    auto const id = frame.telemetry.vehicle_id;
+    auto [it, inserted] = shard.states.try_emplace(id);
+    auto& vehicle = it->second;
+    if (inserted) {
+        vehicle.vehicle_id = id;
+        shard.vehicles.fetch_add(1, std::memory_order_relaxed);
+        network::log_info("Vehicle " + std::to_string(id) + " assigned to shard " + std::to_string(shard_of(id)));
+    }
+    vehicle.source = frame.source;
+    vehicle.latest = frame.telemetry;
+    ++vehicle.frames;
+
+    // Act on where the vehicle is now, not where it was when the frame was
+    // stamped: extrapolate across the time the frame spent queued here
+    auto const accepted = vehicle.predictor.empty() ||
+                          protocol::TelemetryPredictor::timestamp_seconds(frame.telemetry) >
+                              vehicle.predictor.latest_time();
+    auto const error = vehicle.predictor.observe(frame.telemetry);
+    if (accepted) {
+        vehicle.prediction_error = error;
+        auto const queued = std::chrono::duration<double>(std::chrono::steady_clock::now() - frame.received).count();
+        vehicle.predicted = vehicle.predictor.predict(vehicle.predictor.latest_time() + queued);
+    } else {
+        // Reordered, duplicated or from a sender whose clock went back: the
+        // history can't place it, so act on the frame as received rather
+        // than on an extrapolation of older frames
+        vehicle.predicted = frame.telemetry;
+        ++vehicle.stale_frames;
+        frames_stale_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (auto const control = control_law_(vehicle)) {
+        control_sink_(*control, vehicle.source);
+    }
+}
+} // namespace hoverlink
@@ -0,0 +1,83 @@
+#include "hoverlink/telemetry_receiver.hpp"
+#include "hoverlink/telemetry_dispatcher.hpp"
+#include "protocol/dispatch.hpp"
+
+namespace hoverlink {
+TelemetryReceiver::TelemetryReceiver(boost::asio::io_context& io_context, int port,
+    network::SocketOptions const& socket_options)
+    : udp_client_(io_context, port, socket_options),
+      dispatcher_(nullptr),
+      frames_received_(0),
+      frames_rejected_(0),
+      last_queue_latency_ns_(0) {
+    udp_client_.set_message_handler(
+        [this](uint8_t const* data, std::size_t length, boost::asio::ip::udp::endpoint const& sender) {
+            this->handle_datagram(data, length, sender);
+        });
+
+    // Kernel arrival stamps let us tell network delay from our own scheduling delay
+    udp_client_.set_timestamped_message_handler(
+        [this](uint8_t const* data, std::size_t length, boost::asio::ip::udp::endpoint const& sender,
+        network::ReceiveInfo const& info) {
+            if (info.queue_latency) {
+                last_queue_latency_ns_.store(info.queue_latency->count(), std::memory_order_relaxed);
+            }
+            this->handle_datagram(data, length, sender);
+        });
+    udp_client_.enable_receive_timestamps(network::ReceiveTimestamping::Software);
+}
+
+void TelemetryReceiver::start() {
+    udp_client_.start();
+}
+
+void TelemetryReceiver::stop() {
+    udp_client_.stop();
+}
+
+void TelemetryReceiver::set_dispatcher(TelemetryDispatcher* dispatcher) {
+    dispatcher_ = dispatcher;
+}
+
+network::UDPClient& TelemetryReceiver::udp_client() {
+    return udp_client_;
+}
+
+concurrency::SeqlockSnapshot<TelemetryReceiver::Telemetry> const& TelemetryReceiver::latest() const {
+    return latest_;
+}
+
+uint64_t TelemetryReceiver::frames_received() const {
+    return frames_received_.load(std::memory_order_relaxed);
+}
+
+uint64_t TelemetryReceiver::frames_rejected() const {
+    return frames_rejected_.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds TelemetryReceiver::last_queue_latency() const {
+    return std::chrono::nanoseconds(last_queue_latency_ns_.load(std::memory_order_relaxed));
+}
+
+void TelemetryReceiver::handle_datagram(uint8_t const* data, std::size_t length,
+    boost::asio::ip::udp::endpoint const& sender) {
+    // Only telemetry is accepted on this port. The identifier is checked
+    // first, so stray datagrams of other types are never run through a verifier.
+    protocol::Dispatcher frames([this, &sender](Telemetry const& telemetry) {
+        this->handle_telemetry(telemetry, sender);
+    });
+    if (frames.dispatch(data, length) != protocol::DispatchResult::Handled) {
+        frames_rejected_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TelemetryReceiver::handle_telemetry(Telemetry const& telemetry, boost::asio::ip::udp::endpoint const& sender) {
+    // Publishing never waits on readers, so the I/O thread is never stalled
+    latest_.store(telemetry);
+    frames_received_.fetch_add(1, std::memory_order_relaxed);
+
+    if (dispatcher_) {
+        dispatcher_->dispatch(telemetry, sender);
+    }
+}
+} // namespace hoverlink
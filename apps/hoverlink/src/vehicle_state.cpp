@@ -0,0 +1,26 @@
+#include "hoverlink/vehicle_state.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace hoverlink {
+std::optional<protocol::ControlMessage::Control> hover_hold(VehicleState& vehicle) {
+    auto const& state = vehicle.predicted;
+    if (!vehicle.holding) {
+        vehicle.holding = true;
+        vehicle.hold_altitude = state.altitude;
+        vehicle.hold_heading = state.heading;
+    }
+
+    // Heading error wrapped to [-180, 180)
+    auto const heading_error = std::remainder(vehicle.hold_heading - state.heading, 360.0F);
+
+    protocol::ControlMessage::Control control{};
+    control.collective = static_cast<float>(std::clamp(
+        0.5 + 0.002 * (vehicle.hold_altitude - state.altitude) - 0.0002 * state.vertical_speed, 0.0, 1.0));
+    control.cyclic_lat = std::clamp(-state.roll / 30.0F, -1.0F, 1.0F);
+    control.cyclic_lon = std::clamp(state.pitch / 20.0F + state.airspeed / 40.0F, -1.0F, 1.0F);
+    control.pedals = std::clamp(heading_error / 45.0F, -1.0F, 1.0F);
+    control.vehicle_id = vehicle.vehicle_id;
+    return control;
+}
+} // namespace hoverlink
@@ -0,0 +1,140 @@
+// Contention benchmark for SeqlockSnapshot: one writer publishing telemetry-sized
+// values while N readers continuously copy the latest value. A mutex-guarded
+// copy of the same struct is measured alongside as the baseline.
+//
+// usage: seqlock_bench [duration_ms] [max_readers] [writer_rate_hz]
+// A writer rate of 0 publishes back-to-back (worst case for readers).
+#include "concurrency/seqlock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// Same footprint as protocol::TelemetryMessage::Telemetry
+struct Sample {
+    double position[3];
+    float values[19];
+    uint64_t sequence;
+    uint64_t checksum;
+};
+
+Sample make_sample(uint64_t sequence) {
+    Sample sample{};
+    for (auto& value : sample.position) {
+        value = static_cast<double>(sequence);
+    }
+    for (auto& value : sample.values) {
+        value = static_cast<float>(sequence);
+    }
+    sample.sequence = sequence;
+    sample.checksum = ~sequence;
+    return sample;
+}
+
+class MutexSnapshot {
+public:
+    void store(Sample const& value) {
+        std::lock_guard lock(mutex_);
+        value_ = value;
+    }
+
+    Sample load() const {
+        std::lock_guard lock(mutex_);
+        return value_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    Sample value_{};
+};
+
+struct Result {
+    double writes_per_sec;
+    double reads_per_sec;
+    uint64_t torn;
+};
+
+template <typename Snapshot>
+Result run(Snapshot& snapshot, unsigned readers, std::chrono::milliseconds duration, unsigned writer_rate) {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total_reads{0};
+    std::atomic<uint64_t> torn{0};
+    uint64_t writes = 0;
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < readers; ++i) {
+        threads.emplace_back([&] {
+            while (!start.load(std::memory_order_acquire)) {
+                concurrency::cpu_relax();
+            }
+            uint64_t reads = 0;
+            uint64_t bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto const sample = snapshot.load();
+                if (sample.checksum != ~sample.sequence
+                    || sample.values[18] != static_cast<float>(sample.sequence)) {
+                    ++bad;
+                }
+                ++reads;
+            }
+            total_reads.fetch_add(reads);
+            torn.fetch_add(bad);
+        });
+    }
+
+    std::thread writer([&] {
+        while (!start.load(std::memory_order_acquire)) {
+            concurrency::cpu_relax();
+        }
+        auto const period = writer_rate ? std::chrono::nanoseconds(1'000'000'000 / writer_rate) : std::chrono::nanoseconds(0);
+        auto next = std::chrono::steady_clock::now();
+        while (!stop.load(std::memory_order_relaxed)) {
+            snapshot.store(make_sample(++writes));
+            next += period;
+            while (writer_rate && std::chrono::steady_clock::now() < next) {
+                concurrency::cpu_relax();
+            }
+        }
+    });
+
+    auto const begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    writer.join();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    return {static_cast<double>(writes) / seconds, static_cast<double>(total_reads.load()) / seconds, torn.load()};
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    auto const duration = std::chrono::milliseconds(argc > 1 ? std::atoi(argv[1]) : 500);
+    auto const hw = std::max(2U, std::thread::hardware_concurrency());
+    unsigned const max_readers = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : hw - 1;
+    unsigned const writer_rate = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 0;
+
+    std::printf("%-8s %8s %14s %14s %14s %8s\n", "impl", "readers", "writes/s", "reads/s", "reads/s/rdr", "torn");
+    for (unsigned readers = 1; readers <= max_readers; readers *= 2) {
+        concurrency::SeqlockSnapshot<Sample> seqlock(make_sample(0));
+        auto const s = run(seqlock, readers, duration, writer_rate);
+        std::printf("%-8s %8u %14.0f %14.0f %14.0f %8llu\n", "seqlock", readers, s.writes_per_sec, s.reads_per_sec,
+            s.reads_per_sec / readers, static_cast<unsigned long long>(s.torn));
+
+        MutexSnapshot mutex;
+        mutex.store(make_sample(0));
+        auto const m = run(mutex, readers, duration, writer_rate);
+        std::printf("%-8s %8u %14.0f %14.0f %14.0f %8llu\n", "mutex", readers, m.writes_per_sec, m.reads_per_sec,
+            m.reads_per_sec / readers, static_cast<unsigned long long>(m.torn));
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace concurrency {
+// Size used to keep independently written data on separate cache lines
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// Hint to the CPU that we are in a spin-wait loop
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Single-writer / multi-reader snapshot of a trivially copyable value.
+//
+// The writer never blocks and never waits for readers. Readers copy the value
+// without taking a lock and retry if a write overlapped the copy, so they always
+// observe a complete (torn-free) value. The payload is stored as relaxed atomic
+// words, which keeps the concurrent accesses well defined.
+template <typename T>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class SeqlockSnapshot {
+public:
+    SeqlockSnapshot() = default;
+
+    explicit SeqlockSnapshot(T const& initial) {
+        store(initial);
+    }
+
+    SeqlockSnapshot(SeqlockSnapshot const&) = delete;
+    SeqlockSnapshot& operator=(SeqlockSnapshot const&) = delete;
+
+    // Publish a new value. Must only be called from one thread at a time.
+    void store(T const& value) noexcept {
+        std::array<Word, WORD_COUNT> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        auto const seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Copy out the latest published value
+    [[nodiscard]] T load() const noexcept {
+        T value;
+        while (!try_load(value)) {
+            cpu_relax();
+        }
+        return value;
+    }
+
+    // Single read attempt; returns false if it raced with the writer
+    bool try_load(T& value) const noexcept {
+        auto const before = sequence_.load(std::memory_order_acquire);
+        if (before & 1U) {
+            return false;
+        }
+
+        std::array<Word, WORD_COUNT> words;
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            words[i] = data_[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&value, words.data(), sizeof(T));
+        return true;
+    }
+
+    // Number of values published so far
+    [[nodiscard]] uint64_t version() const noexcept {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    using Word = std::uintptr_t;
+    static constexpr std::size_t WORD_COUNT = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+    static_assert(std::atomic<Word>::is_always_lock_free);
+
+    // Sequence counter and payload each start on their own cache line so readers
+    // spinning on the counter don't share a line with unrelated neighbours
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> sequence_{0};
+    alignas(CACHE_LINE_SIZE) std::array<std::atomic<Word>, WORD_COUNT> data_{};
+};
+} // namespace concurrency
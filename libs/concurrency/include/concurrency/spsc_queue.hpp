@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "concurrency/seqlock.hpp"
+
+namespace concurrency {
+// Bounded lock-free single-producer / single-consumer ring buffer.
+//
+// Exactly one thread may push and exactly one (other) thread may pop. Head and
+// tail live on separate cache lines, and each side keeps a cached copy of the
+// other side's index so the shared lines are only touched when the cached
+// value says the queue looks full (producer) or empty (consumer).
+template <typename T, std::size_t Capacity>
+    requires(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0 && std::is_default_constructible_v<T>)
+class SPSCQueue {
+public:
+    SPSCQueue() = default;
+    SPSCQueue(SPSCQueue const&) = delete;
+    SPSCQueue& operator=(SPSCQueue const&) = delete;
+
+    // Producer side; returns false if the queue is full
+    template <typename U>
+    bool try_push(U&& value) noexcept(std::is_nothrow_assignable_v<T&, U&&>) {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity) {
+                return false;
+            }
+        }
+        slots_[tail & MASK] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns nullopt if the queue is empty
+    std::optional<T> try_pop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        auto const head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return std::nullopt;
+            }
+        }
+        std::optional<T> value(std::move(slots_[head & MASK]));
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Approximate; exact only when called from the consumer with the producer idle
+    [[nodiscard]] bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    // Consumer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+
+    // Producer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots_{};
+};
+} // namespace concurrency
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <boost/asio.hpp>
+
+namespace network {
+// Transport addresses taken by the address-based constructors and connect():
+//     unix:/run/hoverlink.sock   Unix domain socket at a filesystem path
+//     @hoverlink                 Linux abstract namespace: no file, released with the socket
+//     127.0.0.1:5502, [::1]:5502, localhost:5502, 5502   IP
+constexpr std::string_view UNIX_ADDRESS_PREFIX = "unix:";
+
+// Longest Unix domain path, including the leading NUL of an abstract name
+constexpr std::size_t MAX_LOCAL_PATH = sizeof(sockaddr_un{}.sun_path) - 1;
+
+struct HostPort {
+    std::string host; // Empty for a bare port
+    int port;
+};
+
+// True for unix: and @ addresses
+bool is_local_address(std::string_view address);
+
+// Split "host:port", "[v6]:port" or "port". Returns nullopt if malformed.
+std::optional<HostPort> parse_host_port(std::string_view address);
+
+// Endpoint of a unix: or @ address, for either local protocol. Returns nullopt
+// for anything else, or a path too long for sockaddr_un.
+template <typename Protocol>
+std::optional<typename Protocol::endpoint> parse_local_address(std::string_view address) {
+    std::string path;
+    if (address.starts_with(UNIX_ADDRESS_PREFIX)) {
+        path = address.substr(UNIX_ADDRESS_PREFIX.size());
+    } else if (address.starts_with('@')) {
+        // Abstract names are paths starting with a NUL byte
+        path.assign(1, '\0');
+        path += address.substr(1);
+    } else {
+        return std::nullopt;
+    }
+    if (path.empty() || path == std::string_view("\0", 1) || path.size() > MAX_LOCAL_PATH) {
+        return std::nullopt;
+    }
+    return typename Protocol::endpoint(path);
+}
+
+// Filesystem path of a local endpoint; empty for abstract and unnamed ones
+template <typename Endpoint>
+std::string socket_file_path(Endpoint const& endpoint) {
+    auto path = endpoint.path();
+    return path.empty() || path.front() == '\0' ? std::string() : path;
+}
+
+// Printable form of an endpoint, in the address syntax above
+template <typename InternetProtocol>
+std::string endpoint_string(boost::asio::ip::basic_endpoint<InternetProtocol> const& endpoint) {
+    return endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+}
+
+template <typename Protocol>
+std::string endpoint_string(boost::asio::local::basic_endpoint<Protocol> const& endpoint) {
+    auto const path = endpoint.path();
+    if (path.empty()) {
+        return "unix:(unnamed)";
+    }
+    return path.front() == '\0' ? "@" + path.substr(1) : std::string(UNIX_ADDRESS_PREFIX) + path;
+}
+
+std::string endpoint_string(boost::asio::generic::stream_protocol::endpoint const& endpoint);
+
+// The IP or Unix domain endpoint behind a generic one, or nullopt for another family
+std::optional<boost::asio::ip::tcp::endpoint> to_tcp_endpoint(
+    boost::asio::generic::stream_protocol::endpoint const& endpoint);
+std::optional<boost::asio::local::stream_protocol::endpoint> to_local_endpoint(
+    boost::asio::generic::stream_protocol::endpoint const& endpoint);
+
+// A socket file as bound, so it is only removed while it is still ours and
+// not one a later process has bound at the same path
+struct SocketFile {
+    std::string path;
+    dev_t device;
+    ino_t inode;
+};
+
+// Make way for binding a path. A socket file nobody answers on (connect()
+// is refused) was left behind by a process that is gone and is removed; one
+// that answers belongs to a live process and throws
+// boost::system::system_error(address_in_use). socket_type is SOCK_STREAM or
+// SOCK_DGRAM. Anything at the path that is not a socket is left to bind().
+void remove_stale_socket_file(std::string const& path, int socket_type);
+
+// Identity of the socket file just bound at path; nullopt for an empty path
+std::optional<SocketFile> bound_socket_file(std::string const& path);
+
+// Remove a socket file if the path still holds the one that was bound
+void remove_socket_file(std::optional<SocketFile> const& file);
+} // namespace network
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/asio.hpp>
+#include "network/common.hpp"
+
+namespace network {
+// Resolved-endpoint cache with a time-to-live.
+//
+// Lookups never block: a fresh entry is returned directly, a stale entry is
+// returned as-is while an asynchronous refresh runs in the background, and a
+// missing entry starts an async_resolve whose completion is delivered to the
+// caller. All member functions must be called from the io_context thread.
+template <typename Protocol>
+class EndpointCache {
+public:
+    using Endpoint = typename Protocol::endpoint;
+    using Clock = std::chrono::steady_clock;
+    using ResolveHandler = std::function<void(std::optional<Endpoint> const&)>;
+
+    static constexpr std::chrono::seconds DEFAULT_TTL{30};
+
+    explicit EndpointCache(boost::asio::io_context& io_context, Clock::duration ttl = DEFAULT_TTL)
+        : resolver_(io_context),
+          ttl_(ttl) {
+    }
+
+    // Return the cached endpoint for host:port if there is one. A stale entry is
+    // still returned, but a background refresh is started for it.
+    std::optional<Endpoint> lookup(std::string const& host, int port) {
+        auto const it = entries_.find(make_key(host, port));
+        if (it == entries_.end() || !it->second.endpoint) {
+            return std::nullopt;
+        }
+        if (Clock::now() >= it->second.expires_at) {
+            refresh(it->first, host, port);
+        }
+        return it->second.endpoint;
+    }
+
+    // Resolve host:port, answering from the cache when possible. The handler is
+    // invoked inline on a cache hit and from the resolver completion otherwise.
+    void resolve(std::string const& host, int port, ResolveHandler handler) {
+        if (auto endpoint = lookup(host, port)) {
+            handler(endpoint);
+            return;
+        }
+        auto const key = make_key(host, port);
+        auto& entry = entries_[key];
+        entry.waiters.push_back(std::move(handler));
+        if (!entry.resolving) {
+            refresh(key, host, port);
+        }
+    }
+
+    // Drop a cached entry, e.g. after the peer stopped answering. Callers
+    // still waiting on its lookup get nullopt.
+    void invalidate(std::string const& host, int port) {
+        auto const it = entries_.find(make_key(host, port));
+        if (it == entries_.end()) {
+            return;
+        }
+        auto waiters = std::move(it->second.waiters);
+        entries_.erase(it);
+        fail(waiters);
+    }
+
+    // Drop everything and cancel lookups in flight; their waiters get nullopt
+    void clear() {
+        std::vector<ResolveHandler> waiters;
+        for (auto& [key, entry] : entries_) {
+            std::move(entry.waiters.begin(), entry.waiters.end(), std::back_inserter(waiters));
+        }
+        entries_.clear();
+        resolver_.cancel();
+        fail(waiters);
+    }
+
+    void set_ttl(Clock::duration ttl) {
+        ttl_ = ttl;
+    }
+
+private:
+    struct Entry {
+        std::optional<Endpoint> endpoint;
+        Clock::time_point expires_at;
+        bool resolving = false;
+        std::vector<ResolveHandler> waiters;
+    };
+
+    static std::string make_key(std::string const& host, int port) {
+        return host + ":" + std::to_string(port);
+    }
+
+    // Answer waiters whose entry is gone. The entry is erased first, so a
+    // waiter may start a new lookup from its handler.
+    static void fail(std::vector<ResolveHandler>& waiters) {
+        for (auto& waiter : waiters) {
+            waiter(std::nullopt);
+        }
+    }
+
+    void refresh(std::string const& key, std::string const& host, int port) {
+        auto& entry = entries_[key];
+        if (entry.resolving) {
+            return;
+        }
+        entry.resolving = true;
+
+        resolver_.async_resolve(host, std::to_string(port),
+            [this, key](boost::system::error_code const& error, typename Protocol::resolver::results_type results) {
+                auto const it = entries_.find(key);
+                if (it == entries_.end()) {
+                    // Invalidated while the lookup was in flight
+                    return;
+                }
+                auto& entry = it->second;
+                entry.resolving = false;
+
+                if (!error && results.begin() != results.end()) {
+                    entry.endpoint = results.begin()->endpoint();
+                    entry.expires_at = Clock::now() + ttl_;
+                } else if (error != boost::asio::error::operation_aborted) {
+                    log_error("Could not resolve " + key + ": " +
+                              (error ? error.message() : std::string("no results")));
+                    // Keep serving a previously known endpoint, but retry on next lookup
+                    entry.expires_at = Clock::now();
+                }
+
+                auto waiters = std::move(entry.waiters);
+                entry.waiters.clear();
+                auto const endpoint = entry.endpoint;
+                if (!endpoint && !entry.resolving) {
+                    entries_.erase(it);
+                }
+                for (auto& waiter : waiters) {
+                    waiter(endpoint);
+                }
+            });
+    }
+
+    typename Protocol::resolver resolver_;
+    Clock::duration ttl_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+} // namespace network
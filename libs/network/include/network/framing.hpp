@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace network {
+// Send priority of a message on a stream connection. Lower values go first.
+enum class Priority : uint8_t {
+    Urgent, // Stop / Pause and other commands that must not wait behind anything
+    Normal, // Regular commands and replies
+    Bulk    // Large payloads: configuration, relayed telemetry, status fan-out
+};
+
+constexpr std::size_t PRIORITY_COUNT = 3;
+
+// Stream connections carry messages as a sequence of chunks, each preceded by
+// a small header naming its priority lane. Chunks of different lanes may be
+// interleaved on the wire, so an urgent message can overtake a large one that
+// is halfway out; within a lane, chunks arrive in order.
+//
+// Header layout (4 bytes):
+//   byte 0     lane in the low bits, FRAME_FINAL set on a message's last chunk
+//   byte 1     reserved, zero
+//   bytes 2-3  chunk payload length, little endian
+constexpr std::size_t FRAME_HEADER_SIZE = 4;
+constexpr uint8_t FRAME_FINAL = 0x80;
+constexpr uint8_t FRAME_LANE_MASK = 0x03;
+
+// Largest chunk a sender produces; also the interleaving granularity
+constexpr std::size_t FRAME_CHUNK_SIZE = 16 * 1024;
+
+// Reassembled messages larger than this are treated as a protocol error, and
+// WriteQueue refuses to queue them
+constexpr std::size_t MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+
+struct FrameHeader {
+    Priority priority;
+    bool final;
+    uint16_t length;
+};
+
+inline void encode_frame_header(uint8_t* out, FrameHeader const& header) {
+    out[0] = static_cast<uint8_t>(static_cast<uint8_t>(header.priority) | (header.final ? FRAME_FINAL : 0));
+    out[1] = 0;
+    out[2] = static_cast<uint8_t>(header.length & 0xFF);
+    out[3] = static_cast<uint8_t>(header.length >> 8);
+}
+
+inline std::optional<FrameHeader> decode_frame_header(uint8_t const* in) {
+    auto const lane = static_cast<uint8_t>(in[0] & FRAME_LANE_MASK);
+    if ((in[0] & ~(FRAME_FINAL | FRAME_LANE_MASK)) != 0 || in[1] != 0 || lane >= PRIORITY_COUNT) {
+        return std::nullopt;
+    }
+    return FrameHeader{static_cast<Priority>(lane), (in[0] & FRAME_FINAL) != 0,
+                       static_cast<uint16_t>(in[2] | (in[3] << 8))};
+}
+
+// Incremental parser for the receiving side of a framed stream.
+//
+// Feed it whatever each read returned; it copes with headers and chunks split
+// across reads and hands complete messages to the handler. A single-chunk
+// message that lies entirely within one read is delivered straight from the
+// read buffer; only chunked or split messages are copied for reassembly.
+class FrameReader {
+public:
+    // Returns false if the stream is malformed; the connection should be closed
+    template <typename Handler>
+    bool feed(uint8_t const* data, std::size_t length, Handler&& handler) {
+        while (length > 0) {
+            if (!in_payload_) {
+                auto const take = std::min(FRAME_HEADER_SIZE - header_bytes_, length);
+                std::copy_n(data, take, header_.begin() + static_cast<std::ptrdiff_t>(header_bytes_));
+                header_bytes_ += take;
+                data += take;
+                length -= take;
+                if (header_bytes_ < FRAME_HEADER_SIZE) {
+                    return true;
+                }
+                header_bytes_ = 0;
+
+                auto const header = decode_frame_header(header_.data());
+                if (!header) {
+                    return false;
+                }
+                current_ = *header;
+                remaining_ = header->length;
+                in_payload_ = true;
+            }
+
+            auto& partial = partial_[static_cast<std::size_t>(current_.priority)];
+            if (current_.final && partial.empty() && remaining_ == current_.length && length >= remaining_) {
+                // Whole message in this read: no copy
+                in_payload_ = false;
+                auto const size = remaining_;
+                data += size;
+                length -= size;
+                handler(data - size, size);
+                continue;
+            }
+
+            auto const take = std::min(remaining_, length);
+            if (partial.size() + take > MAX_MESSAGE_SIZE) {
+                return false;
+            }
+            partial.insert(partial.end(), data, data + take);
+            data += take;
+            length -= take;
+            remaining_ -= take;
+            if (remaining_ == 0) {
+                in_payload_ = false;
+                if (current_.final) {
+                    handler(static_cast<uint8_t const*>(partial.data()), partial.size());
+                    partial.clear();
+                }
+            }
+        }
+        return true;
+    }
+
+    // Forget any partial state, e.g. before reusing the reader for a new connection
+    void reset() {
+        header_bytes_ = 0;
+        remaining_ = 0;
+        in_payload_ = false;
+        for (auto& partial : partial_) {
+            partial.clear();
+        }
+    }
+
+private:
+    std::array<uint8_t, FRAME_HEADER_SIZE> header_{};
+    std::size_t header_bytes_ = 0;
+    FrameHeader current_{};
+    std::size_t remaining_ = 0;
+    bool in_payload_ = false;
+    std::array<std::vector<uint8_t>, PRIORITY_COUNT> partial_;
+};
+} // namespace network
@@ -0,0 +1,50 @@
+#pragma once
+
+#if defined(HOVERLINK_IO_URING)
+
+    #include <array>
+    #include <cstdint>
+    #include <mutex>
+    #include <optional>
+    #include <vector>
+    #include <boost/asio.hpp>
+    #include "network/common.hpp"
+
+namespace network {
+// Receive buffers registered with the io_uring instance of an io_context.
+//
+// io_uring allows a single buffer registration per ring, so the buffers are
+// owned by an io_context service and leased to connections. Reads into a
+// registered buffer skip the per-operation page pinning in the kernel.
+// Connections that cannot get a slot fall back to their own buffer.
+class RegisteredBufferPool : public boost::asio::execution_context::service {
+public:
+    using key_type = RegisteredBufferPool;
+    static boost::asio::execution_context::id id;
+
+    static constexpr std::size_t SLOT_COUNT = 32;
+
+    explicit RegisteredBufferPool(boost::asio::execution_context& context);
+
+    // Lease a slot; nullopt when all slots are in use or registration failed
+    std::optional<std::size_t> acquire();
+    void release(std::size_t slot);
+
+    [[nodiscard]] boost::asio::mutable_registered_buffer buffer(std::size_t slot) const;
+    [[nodiscard]] uint8_t* data(std::size_t slot);
+
+private:
+    void shutdown() override;
+
+    using Slot = std::array<uint8_t, MAX_BUFFER_SIZE>;
+    using BufferSequence = std::vector<boost::asio::mutable_buffer>;
+
+    std::mutex mutex_;
+    std::vector<Slot> storage_;
+    BufferSequence buffers_;
+    std::optional<boost::asio::buffer_registration<BufferSequence>> registration_;
+    std::vector<std::size_t> free_slots_;
+};
+} // namespace network
+
+#endif // HOVERLINK_IO_URING
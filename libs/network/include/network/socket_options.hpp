@@ -0,0 +1,65 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <boost/asio.hpp>
+
+namespace network {
+// Named set of socket options applied by every network class.
+//
+// Unset fields keep the kernel default. Options that don't apply to a socket
+// (TCP_NODELAY on UDP, for example) are skipped, and options the platform or
+// kernel rejects are logged and otherwise ignored, so a profile never stops a
+// socket from working.
+struct SocketOptions {
+    std::string name = "default";
+
+    std::optional<bool> no_delay;           // TCP_NODELAY: disable Nagle
+    std::optional<bool> quick_ack;          // TCP_QUICKACK: re-armed after every read, the kernel clears it
+    std::optional<int> receive_buffer_size; // SO_RCVBUF, bytes
+    std::optional<int> send_buffer_size;    // SO_SNDBUF, bytes
+    std::optional<int> busy_poll;           // SO_BUSY_POLL, microseconds (Linux; privileged above net.core.busy_read)
+    std::optional<int> tos;                 // IP_TOS / IPV6_TCLASS, e.g. 0xB8 for DSCP EF
+
+    // Kernel defaults everywhere
+    static SocketOptions defaults();
+
+    // Small commands and telemetry: no Nagle, immediate ACKs, DSCP EF, and a
+    // small send buffer so queued data waits in the priority lanes rather than
+    // in the kernel. Busy polling is opt-in (low-latency,busy_poll=50) since
+    // unprivileged processes usually can't enable it.
+    static SocketOptions low_latency();
+
+    // Large transfers: Nagle on, large buffers
+    static SocketOptions bulk();
+
+    // Parse a profile spec: a profile name ("default", "low-latency", "bulk"),
+    // optionally followed by overrides, or only overrides for a custom profile:
+    //     low-latency
+    //     bulk,tos=0x20
+    //     nodelay=1,rcvbuf=262144,busy_poll=50
+    // Keys: nodelay, quickack, rcvbuf, sndbuf, busy_poll, tos.
+    // Returns nullopt if the spec is malformed.
+    static std::optional<SocketOptions> parse(std::string_view spec);
+
+    // One-line summary of the options that are set
+    [[nodiscard]] std::string describe() const;
+};
+
+// Apply a profile to an open socket. Rejected options are logged and skipped.
+// Unix domain sockets only take the buffer sizes.
+void apply_socket_options(boost::asio::ip::udp::socket& socket, SocketOptions const& options);
+void apply_socket_options(boost::asio::generic::stream_protocol::socket& socket, SocketOptions const& options);
+void apply_socket_options(boost::asio::local::datagram_protocol::socket& socket, SocketOptions const& options);
+
+// Listening sockets only take the options accepted sockets inherit (buffer
+// sizes, so the window scale is negotiated for them, and TOS)
+void apply_socket_options(boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol>& acceptor,
+    SocketOptions const& options);
+
+// TCP_QUICKACK is not sticky; call after each read when the profile sets it.
+// Instantiated for the generic stream socket the TCP classes use.
+template <typename Socket>
+void rearm_quick_ack(Socket& socket);
+} // namespace network
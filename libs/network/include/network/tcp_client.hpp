@@ -1,46 +1,128 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <memory>
 #include <functional>
+#include <random>
+#include <vector>
 #include <boost/asio.hpp>
 #include "common.hpp"
+#include "network/address.hpp"
+#include "network/framing.hpp"
+#include "network/registered_buffers.hpp"
+#include "network/socket_options.hpp"
+#include "network/write_queue.hpp"
 
 namespace network {
+// Automatic reconnection after the connection drops or an attempt fails.
+// Attempts are spaced by exponential backoff, each delay drawn at random from
+// [delay * (1 - jitter), delay] so clients that lost the same server don't
+// all come back in the same instant.
+struct ReconnectPolicy {
+    bool enabled = false;
+    std::chrono::milliseconds initial_delay{100};
+    std::chrono::milliseconds max_delay{10'000};
+    double multiplier = 2.0;
+    double jitter = 0.5; // Fraction of the delay, clamped to [0, 1]
+
+    // Messages sent while disconnected, and those still unsent when the
+    // connection dropped, are kept up to this many bytes and go out once the
+    // connection is back; past the bound the oldest lowest-priority ones are
+    // dropped. Zero drops them all.
+    std::size_t offline_queue_bytes = 1024 * 1024;
+};
+
+// Stream client for TCP and Unix domain sockets; see address.hpp for the
+// address syntax.
 class TCPClient {
 public:
+    using Endpoint = boost::asio::generic::stream_protocol::endpoint;
     using MessageHandler = std::function<void(uint8_t const*, std::size_t)>;
     using ConnectHandler = std::function<void(bool)>;
     using DisconnectHandler = std::function<void()>;
+    using RestoreHandler = std::function<void()>;
 
-    explicit TCPClient(boost::asio::io_context& io_context);
+    // Socket options are applied once each connection is established
+    explicit TCPClient(boost::asio::io_context& io_context, SocketOptions socket_options = {});
     ~TCPClient();
 
-    // Connect to server
-    void connect(std::string const& host, int port, const ConnectHandler& handler);
+    // Connect to server. Name resolution is asynchronous; the handler is
+    // invoked from the io_context once the connection attempt completes
+    void connect(std::string const& host, int port, ConnectHandler const& handler);
+
+    // Connect to an address: "unix:/run/hoverlink.sock", "@hoverlink" or
+    // "host:port" (resolved as above)
+    void connect(std::string const& address, ConnectHandler const& handler);
+
+    // Connect to already-resolved endpoints, tried in order
+    void connect(boost::asio::ip::tcp::resolver::results_type const& endpoints, ConnectHandler const& handler);
+    void connect(std::vector<Endpoint> endpoints, ConnectHandler const& handler);
 
-    // Send binary data (for flatbuffers)
-    void send_data(uint8_t const* data, std::size_t length);
+    // Send binary data (for flatbuffers). The data is copied into the send queue
+    // of its priority lane; messages queued while a write is in flight go out
+    // together in one batch, highest priority first
+    void send_data(uint8_t const* data, std::size_t length, Priority priority = Priority::Normal);
 
-    // Disconnect from server
+    // Disconnect from server. Also cancels any pending reconnection and drops
+    // the offline queue.
     void disconnect();
 
+    // Reconnect automatically to the endpoints of the last connect() call.
+    // The socket, buffers and queues are reused across attempts.
+    void set_reconnect_policy(ReconnectPolicy const& policy);
+    [[nodiscard]] bool is_reconnecting() const;
+    [[nodiscard]] uint64_t reconnect_attempts() const;
+    [[nodiscard]] uint64_t offline_dropped() const; // Messages dropped because the offline queue was full
+
     // Check if connected
     [[nodiscard]] bool is_connected() const;
 
-    // Set handlers
+    // Set handlers. The message handler receives whole messages, however the
+    // stream was split into reads
     void set_message_handler(MessageHandler handler);
     void set_disconnect_handler(DisconnectHandler handler);
 
+    // Called after every automatic reconnect, before the offline queue is
+    // replayed, to re-send subscriptions or configuration the server lost
+    void set_restore_handler(RestoreHandler handler);
+
 private:
+    void handle_connected(bool restored);
+    void handle_connection_lost();
+    void close_socket();
+    void schedule_reconnect();
     void start_read();
     void handle_read(boost::system::error_code const& error, std::size_t bytes_transferred);
+    void flush();
 
     boost::asio::io_context& io_context_;
-    std::unique_ptr<boost::asio::ip::tcp::socket> socket_;
+    boost::asio::ip::tcp::resolver resolver_;
+    std::unique_ptr<boost::asio::generic::stream_protocol::socket> socket_;
+    SocketOptions socket_options_;
+    bool quick_ack_; // Profile asks for it and the connection is TCP
     std::array<uint8_t, MAX_BUFFER_SIZE> recv_buffer_;
+#if defined(HOVERLINK_IO_URING)
+    RegisteredBufferPool& buffer_pool_;
+    std::optional<std::size_t> registered_slot_;
+#endif
+    WriteQueue write_queue_;
+    FrameReader frame_reader_;
     bool connected_;
+
+    // Reconnection state
+    ReconnectPolicy reconnect_policy_;
+    boost::asio::steady_timer reconnect_timer_;
+    std::vector<Endpoint> endpoints_;
+    std::chrono::milliseconds reconnect_delay_;
+    std::minstd_rand jitter_engine_;
+    WriteQueue offline_queue_;
+    bool reconnecting_;
+    uint64_t reconnect_attempts_;
+    uint64_t offline_dropped_;
+
     MessageHandler message_handler_;
     DisconnectHandler disconnect_handler_;
+    RestoreHandler restore_handler_;
 };
 } // namespace network
@@ -1,44 +1,67 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <functional>
 #include <set>
 #include <boost/asio.hpp>
+#include "network/address.hpp"
 #include "network/common.hpp"
+#include "network/framing.hpp"
+#include "network/registered_buffers.hpp"
+#include "network/socket_options.hpp"
+#include "network/write_queue.hpp"
 
 namespace network {
+// Connections and the server run on generic stream sockets, so the same
+// classes serve TCP and Unix domain stream sockets.
 class TCPConnection : public std::enable_shared_from_this<TCPConnection> {
 public:
+    using Socket = boost::asio::generic::stream_protocol::socket;
+
     using MessageHandler = std::function<void(uint8_t const*, std::size_t,
                                               std::shared_ptr<TCPConnection>)>;
     using DisconnectHandler = std::function<void(std::shared_ptr<TCPConnection>)>;
 
-    explicit TCPConnection(boost::asio::ip::tcp::socket socket);
+    explicit TCPConnection(Socket socket, SocketOptions const& socket_options = {});
+    ~TCPConnection();
 
     // Start reading data from the connection
     void start();
 
-    // Send binary data (flatbuffers)
-    void send_data(uint8_t const* data, std::size_t length);
+    // Send binary data (flatbuffers). The data is copied into the send queue
+    // of its priority lane; messages queued while a write is in flight go out
+    // together in one batch, highest priority first
+    void send_data(uint8_t const* data, std::size_t length, Priority priority = Priority::Normal);
 
     // Close the connection
     void close();
 
-    // Get endpoint information
+    // Get endpoint information. The string is "ip:port" or a unix: address;
+    // the TCP endpoint is unspecified for Unix domain peers.
     std::string get_endpoint_string() const;
     boost::asio::ip::tcp::endpoint get_endpoint() const;
 
-    // Set handlers
+    // Set handlers. The message handler receives whole messages, however the
+    // stream was split into reads
     void set_message_handler(MessageHandler handler);
     void set_disconnect_handler(DisconnectHandler handler);
 
 private:
     void start_read();
     void handle_read(boost::system::error_code const& error, std::size_t bytes_transferred);
+    void flush();
 
-    boost::asio::ip::tcp::socket socket_;
+    Socket socket_;
     std::array<uint8_t, MAX_BUFFER_SIZE> recv_buffer_;
+#if defined(HOVERLINK_IO_URING)
+    RegisteredBufferPool* buffer_pool_ = nullptr;
+    std::optional<std::size_t> registered_slot_;
+#endif
+    WriteQueue write_queue_;
+    FrameReader frame_reader_;
+    bool quick_ack_;
     MessageHandler message_handler_;
     DisconnectHandler disconnect_handler_;
 };
@@ -47,8 +70,21 @@ class TCPServer {
 public:
     using ConnectionHandler = std::function<void(std::shared_ptr<TCPConnection>)>;
 
+    // Socket options are applied to the listening socket (the inherited ones)
+    // and to every accepted connection
     explicit TCPServer(boost::asio::io_context& io_context,
-                       int port = DEFAULT_TCP_PORT);
+                       int port = DEFAULT_TCP_PORT,
+                       SocketOptions socket_options = {});
+
+    // Listen on an address (see address.hpp): "unix:/run/hoverlink.sock",
+    // "@hoverlink", "0.0.0.0:5502" or a port. A stale socket file at a unix:
+    // path is replaced, and removed again by stop() or destruction; one a live
+    // server still listens on throws boost::system::system_error (address in
+    // use). Throws std::invalid_argument for a malformed address.
+    TCPServer(boost::asio::io_context& io_context,
+              std::string const& address,
+              SocketOptions socket_options = {});
+    ~TCPServer();
 
     // Start accepting connections
     void start();
@@ -57,11 +93,17 @@ public:
     void stop();
 
     // Broadcast data to all clients
-    void broadcast(uint8_t const* data, std::size_t length) const;
+    void broadcast(uint8_t const* data, std::size_t length, Priority priority = Priority::Normal) const;
 
     // Get number of connected clients
     [[nodiscard]] std::size_t connection_count() const;
 
+    // Get local port (useful when constructed with port 0); 0 for Unix domain sockets
+    [[nodiscard]] int get_local_port() const;
+
+    // Listening address in the syntax the constructor takes
+    [[nodiscard]] std::string get_local_address() const;
+
     // Set handlers
     void set_connection_handler(ConnectionHandler handler);
 
@@ -71,8 +113,16 @@ private:
                        boost::system::error_code const& error);
     void handle_client_disconnect(std::shared_ptr<TCPConnection> connection);
 
+    TCPServer(boost::asio::io_context& io_context,
+              boost::asio::generic::stream_protocol::endpoint const& endpoint,
+              SocketOptions socket_options);
+
+    static boost::asio::generic::stream_protocol::endpoint make_listen_endpoint(std::string const& address);
+
     boost::asio::io_context& io_context_;
-    boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol> acceptor_;
+    std::optional<SocketFile> socket_file_; // Removed on stop(), for unix: addresses
+    SocketOptions socket_options_;
     bool running_;
     std::set<std::shared_ptr<TCPConnection>> connections_;
     ConnectionHandler connection_handler_;
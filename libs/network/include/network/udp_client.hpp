@@ -1,19 +1,65 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include <functional>
 #include <boost/asio.hpp>
+#include "network/address.hpp"
 #include "network/common.hpp"
+#include "network/endpoint_cache.hpp"
+#include "network/socket_options.hpp"
 
 namespace network {
-class UDPClient {
+// Source of kernel receive timestamps
+enum class ReceiveTimestamping {
+    Disabled,
+    Software, // SO_TIMESTAMPNS: stamped when the kernel queued the datagram
+    Hardware  // SO_TIMESTAMPING: NIC timestamp as well, when the driver provides one
+};
+
+// Arrival information for a datagram received with timestamping enabled
+struct ReceiveInfo {
+    // Kernel arrival time (software clock), and the time spent queued in the
+    // socket and io_context. Unset if the kernel attached no timestamp.
+    std::optional<std::chrono::system_clock::time_point> kernel_time;
+    std::optional<std::chrono::nanoseconds> queue_latency;
+    std::chrono::system_clock::time_point dispatch_time; // When the handler was invoked
+    std::optional<std::chrono::nanoseconds> hardware_time; // Raw NIC clock, not comparable to system_clock
+};
+
+template <typename Protocol>
+constexpr bool is_ip_datagram_v = std::is_same_v<Protocol, boost::asio::ip::udp>;
+
+// Datagram client for UDP and Unix domain datagram sockets, with the same
+// handler API over both. Name resolution, host:port sends and the local port
+// only exist for UDP; Unix domain sockets are addressed by unix: path or
+// @abstract name (see address.hpp). Instantiated for the two protocols below.
+template <typename Protocol>
+class DatagramClient {
 public:
-    using MessageHandler = std::function<void(uint8_t const*, std::size_t,
-                                              boost::asio::ip::udp::endpoint const&)>;
+    using Endpoint = typename Protocol::endpoint;
+    using MessageHandler = std::function<void(uint8_t const*, std::size_t, Endpoint const&)>;
+    using TimestampedMessageHandler = std::function<void(uint8_t const*, std::size_t,
+                                                         Endpoint const&, ReceiveInfo const&)>;
+    using ConnectHandler = std::function<void(bool)>;
 
-    explicit UDPClient(boost::asio::io_context& io_context, int local_port = 0);
-    ~UDPClient();
+    explicit DatagramClient(boost::asio::io_context& io_context, int local_port = 0,
+                            SocketOptions const& socket_options = {})
+        requires is_ip_datagram_v<Protocol>;
+
+    // Bind to "unix:/path" or "@name". A stale socket file at the path is
+    // replaced, and removed again on destruction; one a live socket is still
+    // bound to throws boost::system::system_error (address in use). Without an
+    // address Linux autobinds an abstract name, so peers can still reply.
+    // Throws std::invalid_argument for a malformed address.
+    explicit DatagramClient(boost::asio::io_context& io_context, std::string const& address = {},
+                            SocketOptions const& socket_options = {})
+        requires (!is_ip_datagram_v<Protocol>);
+    ~DatagramClient();
 
     // Start receiving data
     void start();
@@ -21,29 +67,89 @@ public:
     // Stop receiving data
     void stop();
 
-    // Send data to a specific endpoint
-    void send_data(uint8_t const* data, std::size_t length,
-                   boost::asio::ip::udp::endpoint const& endpoint);
+    // Send data to a specific endpoint. The send is asynchronous: the buffer
+    // must stay valid until it completes.
+    void send_data(uint8_t const* data, std::size_t length, Endpoint const& endpoint);
+
+    // Send an owned buffer to a specific endpoint; it is kept alive until the send
+    // completes, so it is safe to call from code that built the message on the fly
+    void send_data(std::vector<uint8_t> data, Endpoint const& endpoint);
 
-    // Send data to a specific host and port
+    // Send data to a specific host and port. The name is resolved through the
+    // endpoint cache, so only the first send (and periodic refreshes) hit the resolver
     void send_data(uint8_t const* data, std::size_t length,
-                   std::string const& host, int port);
+                   std::string const& host, int port)
+        requires is_ip_datagram_v<Protocol>;
+
+    // Connected mode: fix the peer once, then use send() without an address
+    void connect(std::string const& host, int port, ConnectHandler const& handler)
+        requires is_ip_datagram_v<Protocol>;
+    void connect(Endpoint const& endpoint);
+    void disconnect();
+    [[nodiscard]] bool is_connected() const;
+
+    // Send data to the connected peer; the buffer must outlive the send
+    void send(uint8_t const* data, std::size_t length);
+
+    // Send an owned buffer to the connected peer, kept alive until the send completes
+    void send(std::vector<uint8_t> data);
+
+    // Time-to-live of cached host:port resolutions
+    void set_resolve_ttl(std::chrono::steady_clock::duration ttl)
+        requires is_ip_datagram_v<Protocol>;
 
     // Set handler for received messages
     void set_message_handler(MessageHandler handler);
 
+    // Opt in to kernel receive timestamps. Datagrams are then read with recvmsg
+    // and delivered to the timestamped handler (or the plain handler if unset).
+    // Returns false if the platform or socket rejects the option.
+    bool enable_receive_timestamps(ReceiveTimestamping mode = ReceiveTimestamping::Software);
+    void set_timestamped_message_handler(TimestampedMessageHandler handler);
+
     // Get local port
-    [[nodiscard]] int get_local_port() const;
+    [[nodiscard]] int get_local_port() const
+        requires is_ip_datagram_v<Protocol>;
+
+    // Bound address, in the syntax the constructors take
+    [[nodiscard]] std::string get_local_address() const;
 
 private:
+    // Unix domain sockets have nothing to resolve
+    struct NoEndpointCache {
+        explicit NoEndpointCache(boost::asio::io_context& /*io_context*/) {
+        }
+        void clear() {
+        }
+    };
+
+    static constexpr char const* NAME = is_ip_datagram_v<Protocol> ? "UDP" : "Unix datagram";
+
+    // Datagrams read per readiness wakeup in timestamped mode, so a steady
+    // stream can't keep the io_context from running other handlers
+    static constexpr std::size_t MAX_DATAGRAMS_PER_WAKEUP = 64;
+
     void start_receive();
     void handle_receive(boost::system::error_code const& error, std::size_t bytes_transferred);
+    void start_timestamped_receive();
+    void drain_timestamped();
 
     boost::asio::io_context& io_context_;
-    boost::asio::ip::udp::socket socket_;
-    boost::asio::ip::udp::endpoint remote_endpoint_;
+    typename Protocol::socket socket_;
+    std::conditional_t<is_ip_datagram_v<Protocol>, EndpointCache<Protocol>, NoEndpointCache> endpoint_cache_;
+    Endpoint remote_endpoint_;
+    std::optional<SocketFile> socket_file_; // Removed on destruction, for unix: addresses
     std::array<uint8_t, MAX_BUFFER_SIZE> recv_buffer_;
     bool running_;
+    bool connected_;
+    ReceiveTimestamping timestamping_;
     MessageHandler message_handler_;
+    TimestampedMessageHandler timestamped_handler_;
 };
+
+using UDPClient = DatagramClient<boost::asio::ip::udp>;
+using LocalDatagramClient = DatagramClient<boost::asio::local::datagram_protocol>;
+
+extern template class DatagramClient<boost::asio::ip::udp>;
+extern template class DatagramClient<boost::asio::local::datagram_protocol>;
 } // namespace network
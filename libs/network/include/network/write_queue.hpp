@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <boost/asio.hpp>
+#include "network/framing.hpp"
+
+namespace network {
+// Outgoing message queue for stream sockets.
+//
+// Messages are copied on push, so callers don't have to keep their buffer
+// alive until the asynchronous write completes. Each priority has its own
+// lane, and lanes are drained strictly in priority order: every batch starts
+// with whatever is queued on the urgent lane. Messages are framed and cut into
+// chunks of at most FRAME_CHUNK_SIZE (see framing.hpp), so a large bulk
+// message only ever holds the socket for one batch before an urgent one can
+// overtake it.
+//
+// Everything queued while a write is in flight is sent by the next write as
+// one gather batch, which turns a burst of small FlatBuffer messages into a
+// single syscall (or a single io_uring submission). Message buffers are
+// recycled between batches.
+class WriteQueue {
+public:
+    // Upper bound on chunks / payload bytes handed to a single write. The byte
+    // bound is also the longest an urgent message can wait behind bulk data.
+    static constexpr std::size_t MAX_BATCH_CHUNKS = 64;
+    static constexpr std::size_t MAX_BATCH_BYTES = 64 * 1024;
+
+    // Queue a copy of the message on the given lane. Messages over
+    // MAX_MESSAGE_SIZE, which the receiving FrameReader would reject by closing
+    // the connection, are logged and refused with false.
+    bool push(uint8_t const* data, std::size_t length, Priority priority = Priority::Normal);
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] bool writing() const;
+    [[nodiscard]] std::size_t queued_bytes() const;
+
+    // Move the next batch in flight and return its gather list. The list stays
+    // valid until end_batch() is called.
+    std::vector<boost::asio::const_buffer> const& begin_batch();
+
+    // Release the in-flight batch once its write has completed
+    void end_batch();
+
+    // Drop everything, e.g. when the connection is closed
+    void clear();
+
+    // Move the unsent messages of another queue to the back of this one, lane
+    // by lane. A message the other queue had partly sent is copied whole, so it
+    // goes out from the start on the next connection; the original stays with
+    // the other queue's batch until its end_batch().
+    //
+    // Together with clear() and trim(), which also hold partly sent messages
+    // back for end_batch(), this means nothing a write in flight points at is
+    // freed before the write completes, even when it completes after a close.
+    void take_pending_from(WriteQueue& other);
+
+    // Drop messages until at most max_bytes are queued: the bulk lane first,
+    // oldest first within a lane. Returns the number of messages dropped.
+    std::size_t trim(std::size_t max_bytes);
+
+private:
+    struct Lane {
+        std::deque<std::vector<uint8_t>> messages;
+        std::size_t offset = 0; // Bytes of the front message already handed to a batch
+    };
+
+    std::vector<uint8_t> take_spare();
+
+    std::array<Lane, PRIORITY_COUNT> lanes_;
+    std::vector<std::vector<uint8_t>> in_flight_;
+    std::array<std::array<uint8_t, FRAME_HEADER_SIZE>, MAX_BATCH_CHUNKS> headers_{};
+    std::vector<boost::asio::const_buffer> gather_;
+    std::vector<std::vector<uint8_t>> spare_;
+    std::size_t queued_bytes_ = 0;
+    bool writing_ = false;
+};
+} // namespace network
@@ -0,0 +1,118 @@
+#include "network/address.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace network {
+bool is_local_address(std::string_view address) {
+    return address.starts_with(UNIX_ADDRESS_PREFIX) || address.starts_with('@');
+}
+
+std::optional<HostPort> parse_host_port(std::string_view address) {
+    std::string_view host;
+    std::string_view port = address;
+    if (address.starts_with('[')) {
+        auto const close = address.find(']');
+        if (close == std::string_view::npos || close + 1 >= address.size() || address[close + 1] != ':') {
+            return std::nullopt;
+        }
+        host = address.substr(1, close - 1);
+        port = address.substr(close + 2);
+    } else if (auto const colon = address.rfind(':'); colon != std::string_view::npos) {
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+        if (host.empty() || host.find(':') != std::string_view::npos) {
+            // Unbracketed IPv6 is ambiguous
+            return std::nullopt;
+        }
+    }
+
+    int value = 0;
+    auto const [end, error] = std::from_chars(port.data(), port.data() + port.size(), value);
+    if (port.empty() || error != std::errc() || end != port.data() + port.size() || value < 0 || value > 65535) {
+        return std::nullopt;
+    }
+    return HostPort{std::string(host), value};
+}
+
+std::string endpoint_string(boost::asio::generic::stream_protocol::endpoint const& endpoint) {
+    if (auto const tcp = to_tcp_endpoint(endpoint)) {
+        return endpoint_string(*tcp);
+    }
+    if (auto const local = to_local_endpoint(endpoint)) {
+        return endpoint_string(*local);
+    }
+    return "unknown";
+}
+
+std::optional<boost::asio::ip::tcp::endpoint> to_tcp_endpoint(
+    boost::asio::generic::stream_protocol::endpoint const& endpoint) {
+    auto const family = endpoint.protocol().family();
+    if (family != AF_INET && family != AF_INET6) {
+        return std::nullopt;
+    }
+    boost::asio::ip::tcp::endpoint tcp;
+    std::memcpy(tcp.data(), endpoint.data(), endpoint.size());
+    tcp.resize(endpoint.size());
+    return tcp;
+}
+
+std::optional<boost::asio::local::stream_protocol::endpoint> to_local_endpoint(
+    boost::asio::generic::stream_protocol::endpoint const& endpoint) {
+    if (endpoint.protocol().family() != AF_UNIX) {
+        return std::nullopt;
+    }
+    boost::asio::local::stream_protocol::endpoint local;
+    std::memcpy(local.data(), endpoint.data(), endpoint.size());
+    local.resize(endpoint.size());
+    return local;
+}
+
+void remove_stale_socket_file(std::string const& path, int socket_type) {
+    struct stat status{};
+    if (path.empty() || ::lstat(path.c_str(), &status) != 0 || !S_ISSOCK(status.st_mode)) {
+        return;
+    }
+
+    // Non-blocking, so a listener with a full backlog answers EAGAIN rather
+    // than stalling us; that still counts as alive
+    int const probe = ::socket(AF_UNIX, socket_type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        return;
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.data(), std::min(path.size(), MAX_LOCAL_PATH));
+    auto const connected = ::connect(probe, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) == 0;
+    auto const error = errno;
+    ::close(probe);
+
+    if (!connected && error == ECONNREFUSED) {
+        ::unlink(path.c_str());
+    } else if (connected || error == EAGAIN || error == EINPROGRESS) {
+        throw boost::system::system_error(boost::asio::error::address_in_use, path);
+    }
+    // Anything else (permissions, a vanished file): let bind() report it
+}
+
+std::optional<SocketFile> bound_socket_file(std::string const& path) {
+    struct stat status{};
+    if (path.empty() || ::lstat(path.c_str(), &status) != 0) {
+        return std::nullopt;
+    }
+    return SocketFile{path, status.st_dev, status.st_ino};
+}
+
+void remove_socket_file(std::optional<SocketFile> const& file) {
+    struct stat status{};
+    if (file && ::lstat(file->path.c_str(), &status) == 0 && status.st_dev == file->device &&
+        status.st_ino == file->inode) {
+        ::unlink(file->path.c_str());
+    }
+}
+} // namespace network
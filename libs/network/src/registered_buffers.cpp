@@ -0,0 +1,57 @@
+#include "network/registered_buffers.hpp"
+
+#if defined(HOVERLINK_IO_URING)
+
+namespace network {
+boost::asio::execution_context::id RegisteredBufferPool::id;
+
+RegisteredBufferPool::RegisteredBufferPool(boost::asio::execution_context& context)
+    : boost::asio::execution_context::service(context),
+      storage_(SLOT_COUNT) {
+    for (auto& slot : storage_) {
+        buffers_.emplace_back(slot.data(), slot.size());
+    }
+
+    try {
+        registration_.emplace(boost::asio::register_buffers(context, buffers_));
+        for (std::size_t slot = SLOT_COUNT; slot > 0; --slot) {
+            free_slots_.push_back(slot - 1);
+        }
+        log_info("Registered " + std::to_string(SLOT_COUNT) + " io_uring receive buffers");
+    } catch (std::exception const& e) {
+        // Typically RLIMIT_MEMLOCK; reads still work with unregistered buffers
+        log_error("io_uring buffer registration failed: " + std::string(e.what()));
+    }
+}
+
+std::optional<std::size_t> RegisteredBufferPool::acquire() {
+    std::lock_guard lock(mutex_);
+    if (free_slots_.empty()) {
+        return std::nullopt;
+    }
+    auto const slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+}
+
+void RegisteredBufferPool::release(std::size_t slot) {
+    std::lock_guard lock(mutex_);
+    free_slots_.push_back(slot);
+}
+
+boost::asio::mutable_registered_buffer RegisteredBufferPool::buffer(std::size_t slot) const {
+    return (*registration_)[slot];
+}
+
+uint8_t* RegisteredBufferPool::data(std::size_t slot) {
+    return storage_[slot].data();
+}
+
+void RegisteredBufferPool::shutdown() {
+    std::lock_guard lock(mutex_);
+    registration_.reset();
+    free_slots_.clear();
+}
+} // namespace network
+
+#endif // HOVERLINK_IO_URING
@@ -0,0 +1,265 @@
+#include "network/socket_options.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include "network/common.hpp"
+
+#if defined(__linux__)
+    #include <netinet/in.h>
+    #include <netinet/ip.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+#endif
+
+namespace network {
+namespace {
+bool parse_int(std::string_view text, int& value) {
+    try {
+        std::size_t used = 0;
+        value = std::stoi(std::string(text), &used, 0); // Base 0 accepts 0x.. for TOS
+        return used == text.size();
+    } catch (std::exception const&) {
+        return false;
+    }
+}
+
+bool apply_override(SocketOptions& options, std::string_view key, std::string_view text) {
+    int value = 0;
+    if (!parse_int(text, value)) {
+        return false;
+    }
+    if (key == "nodelay") {
+        options.no_delay = value != 0;
+    } else if (key == "quickack") {
+        options.quick_ack = value != 0;
+    } else if (key == "rcvbuf") {
+        options.receive_buffer_size = value;
+    } else if (key == "sndbuf") {
+        options.send_buffer_size = value;
+    } else if (key == "busy_poll") {
+        options.busy_poll = value;
+    } else if (key == "tos") {
+        options.tos = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template <typename Option, typename Socket>
+void set_option(Socket& socket, Option const& option, char const* name) {
+    boost::system::error_code ec;
+    std::ignore = socket.set_option(option, ec);
+    if (ec) {
+        log_error(std::string("Failed to set ") + name + ": " + ec.message());
+    }
+}
+
+#if defined(__linux__)
+// Set when SO_BUSY_POLL was refused for lack of privilege, so that is only reported once
+std::atomic<bool> busy_poll_denied{false};
+
+void set_raw_option(int fd, int level, int option, int value, char const* name) {
+    if (::setsockopt(fd, level, option, &value, sizeof(value)) == 0) {
+        return;
+    }
+    if (option == SO_BUSY_POLL && level == SOL_SOCKET && errno == EPERM) {
+        // Values above net.core.busy_read need CAP_NET_ADMIN; every socket would fail the same way
+        if (!busy_poll_denied.exchange(true)) {
+            log_error("SO_BUSY_POLL needs CAP_NET_ADMIN above net.core.busy_read; not busy polling");
+        }
+        return;
+    }
+    log_error(std::string("Failed to set ") + name + ": " + std::strerror(errno));
+}
+#endif
+
+// Options shared by TCP and UDP sockets
+template <typename Socket>
+void apply_common(Socket& socket, SocketOptions const& options, bool v6) {
+    if (options.receive_buffer_size) {
+        set_option(socket, boost::asio::socket_base::receive_buffer_size(*options.receive_buffer_size), "SO_RCVBUF");
+    }
+    if (options.send_buffer_size) {
+        set_option(socket, boost::asio::socket_base::send_buffer_size(*options.send_buffer_size), "SO_SNDBUF");
+    }
+#if defined(__linux__)
+    auto const fd = socket.native_handle();
+    if (options.tos) {
+        if (v6) {
+            set_raw_option(fd, IPPROTO_IPV6, IPV6_TCLASS, *options.tos, "IPV6_TCLASS");
+        } else {
+            set_raw_option(fd, IPPROTO_IP, IP_TOS, *options.tos, "IP_TOS");
+        }
+    }
+    if (options.busy_poll) {
+        set_raw_option(fd, SOL_SOCKET, SO_BUSY_POLL, *options.busy_poll, "SO_BUSY_POLL");
+    }
+#else
+    (void)v6;
+#endif
+}
+
+// Address family of a generic socket, or AF_UNSPEC if it isn't bound
+template <typename Socket>
+int family_of(Socket const& socket) {
+    boost::system::error_code ec;
+    auto const endpoint = socket.local_endpoint(ec);
+    return ec ? AF_UNSPEC : endpoint.protocol().family();
+}
+
+// Only the buffer sizes mean anything to a Unix domain socket
+SocketOptions buffer_options(SocketOptions const& options) {
+    SocketOptions buffers;
+    buffers.receive_buffer_size = options.receive_buffer_size;
+    buffers.send_buffer_size = options.send_buffer_size;
+    return buffers;
+}
+
+template <typename Socket>
+void apply_stream_options(Socket& socket, SocketOptions const& options, bool v6) {
+    apply_common(socket, options, v6);
+    if (options.no_delay) {
+        set_option(socket, boost::asio::ip::tcp::no_delay(*options.no_delay), "TCP_NODELAY");
+    }
+#if defined(__linux__)
+    if (options.quick_ack) {
+        set_raw_option(socket.native_handle(), IPPROTO_TCP, TCP_QUICKACK, *options.quick_ack ? 1 : 0,
+            "TCP_QUICKACK");
+    }
+#endif
+}
+
+template <typename Acceptor>
+void apply_listen_options(Acceptor& acceptor, SocketOptions const& options, bool v6) {
+    auto inherited = buffer_options(options);
+    inherited.tos = options.tos;
+    apply_common(acceptor, inherited, v6);
+}
+} // namespace
+
+SocketOptions SocketOptions::defaults() {
+    return {};
+}
+
+SocketOptions SocketOptions::low_latency() {
+    SocketOptions options;
+    options.name = "low-latency";
+    options.no_delay = true;
+    options.quick_ack = true;
+    options.send_buffer_size = 64 * 1024;
+    options.tos = 0xB8;
+    return options;
+}
+
+SocketOptions SocketOptions::bulk() {
+    SocketOptions options;
+    options.name = "bulk";
+    options.no_delay = false;
+    options.receive_buffer_size = 4 * 1024 * 1024;
+    options.send_buffer_size = 4 * 1024 * 1024;
+    return options;
+}
+
+std::optional<SocketOptions> SocketOptions::parse(std::string_view spec) {
+    auto const full_spec = spec;
+    SocketOptions options;
+    bool first = true;
+    while (!spec.empty()) {
+        auto const comma = spec.find(',');
+        auto const item = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+
+        auto const eq = item.find('=');
+        if (eq == std::string_view::npos) {
+            // A bare name selects the base profile and must come first
+            if (!first) {
+                return std::nullopt;
+            }
+            if (item == "default") {
+                options = defaults();
+            } else if (item == "low-latency") {
+                options = low_latency();
+            } else if (item == "bulk") {
+                options = bulk();
+            } else {
+                return std::nullopt;
+            }
+        } else if (!apply_override(options, item.substr(0, eq), item.substr(eq + 1))) {
+            return std::nullopt;
+        } else {
+            // Overrides make it a custom profile, named after its spec
+            options.name = std::string(full_spec);
+        }
+        first = false;
+    }
+    return options;
+}
+
+std::string SocketOptions::describe() const {
+    std::string text;
+    auto const add = [&text](char const* key, int value) {
+        text += (text.empty() ? "" : ",") + std::string(key) + "=" + std::to_string(value);
+    };
+    if (no_delay) {
+        add("nodelay", *no_delay);
+    }
+    if (quick_ack) {
+        add("quickack", *quick_ack);
+    }
+    if (receive_buffer_size) {
+        add("rcvbuf", *receive_buffer_size);
+    }
+    if (send_buffer_size) {
+        add("sndbuf", *send_buffer_size);
+    }
+    if (busy_poll) {
+        add("busy_poll", *busy_poll);
+    }
+    if (tos) {
+        add("tos", *tos);
+    }
+    return text.empty() ? "kernel defaults" : text;
+}
+
+void apply_socket_options(boost::asio::ip::udp::socket& socket, SocketOptions const& options) {
+    boost::system::error_code ec;
+    auto const endpoint = socket.local_endpoint(ec);
+    apply_common(socket, options, !ec && endpoint.address().is_v6());
+}
+
+void apply_socket_options(boost::asio::generic::stream_protocol::socket& socket, SocketOptions const& options) {
+    auto const family = family_of(socket);
+    if (family == AF_INET || family == AF_INET6) {
+        apply_stream_options(socket, options, family == AF_INET6);
+    } else {
+        apply_common(socket, buffer_options(options), false);
+    }
+}
+
+void apply_socket_options(boost::asio::local::datagram_protocol::socket& socket, SocketOptions const& options) {
+    apply_common(socket, buffer_options(options), false);
+}
+
+void apply_socket_options(boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol>& acceptor,
+    SocketOptions const& options) {
+    auto const family = family_of(acceptor);
+    if (family == AF_INET || family == AF_INET6) {
+        apply_listen_options(acceptor, options, family == AF_INET6);
+    } else {
+        apply_common(acceptor, buffer_options(options), false);
+    }
+}
+
+template <typename Socket>
+void rearm_quick_ack(Socket& socket) {
+#if defined(__linux__)
+    int const one = 1;
+    ::setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+#else
+    (void)socket;
+#endif
+}
+
+template void rearm_quick_ack(boost::asio::generic::stream_protocol::socket& socket);
+} // namespace network
@@ -1,20 +1,42 @@
 #include "network/tcp_client.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace network {
-TCPClient::TCPClient(boost::asio::io_context& io_context)
+TCPClient::TCPClient(boost::asio::io_context& io_context, SocketOptions socket_options)
     : io_context_(io_context),
-      socket_(std::make_unique<boost::asio::ip::tcp::socket>(io_context)),
+      resolver_(io_context),
+      socket_(std::make_unique<boost::asio::generic::stream_protocol::socket>(io_context)),
+      socket_options_(std::move(socket_options)),
+      quick_ack_(false),
+#if defined(HOVERLINK_IO_URING)
+      buffer_pool_(boost::asio::use_service<RegisteredBufferPool>(io_context)),
+      registered_slot_(buffer_pool_.acquire()),
+#endif
       connected_(false),
+      reconnect_timer_(io_context),
+      reconnect_delay_(reconnect_policy_.initial_delay),
+      jitter_engine_(std::random_device{}()),
+      reconnecting_(false),
+      reconnect_attempts_(0),
+      offline_dropped_(0),
       message_handler_([](uint8_t const*, std::size_t) {
       }),
       disconnect_handler_([]() {
+      }),
+      restore_handler_([]() {
       }) {
     log_info("TCP client initialized");
 }
 
 TCPClient::~TCPClient() {
+    resolver_.cancel();
     disconnect();
+#if defined(HOVERLINK_IO_URING)
+    if (registered_slot_) {
+        buffer_pool_.release(*registered_slot_);
+    }
+#endif
 }
 
 void TCPClient::connect(std::string const& host, int port, ConnectHandler const& handler) {
@@ -22,41 +44,167 @@ void TCPClient::connect(std::string const& host, int port, ConnectHandler const&
         disconnect();
     }
 
-    boost::asio::ip::tcp::resolver resolver(io_context_);
+    // Resolve asynchronously so a slow name lookup never stalls the io_context
+    resolver_.cancel();
+    resolver_.async_resolve(host, std::to_string(port),
+        [this, host, handler](boost::system::error_code const& error,
+        boost::asio::ip::tcp::resolver::results_type const& endpoints) {
+            if (error) {
+                if (error != boost::asio::error::operation_aborted) {
+                    log_error("Resolve error for " + host + ": " + error.message());
+                }
+                handler(false);
+                return;
+            }
+            connect(endpoints, handler);
+        });
+}
 
-    try {
-        auto endpoints = resolver.resolve(host, std::to_string(port));
+void TCPClient::connect(std::string const& address, ConnectHandler const& handler) {
+    if (auto const local = parse_local_address<boost::asio::local::stream_protocol>(address)) {
+        connect(std::vector<Endpoint>{*local}, handler);
+        return;
+    }
+    auto const host_port = parse_host_port(address);
+    if (!host_port || host_port->host.empty()) {
+        log_error("Invalid address: " + address);
+        handler(false);
+        return;
+    }
+    connect(host_port->host, host_port->port, handler);
+}
 
-        boost::asio::async_connect(*socket_, endpoints,
-            [this, handler](boost::system::error_code const& error,
-            boost::asio::ip::tcp::endpoint const& /*endpoint*/) {
-                if (!error) {
-                    connected_ = true;
-                    log_info("Connected to server at " +
-                             socket_->remote_endpoint().address().to_string() + ":" +
-                             std::to_string(socket_->remote_endpoint().port()));
+void TCPClient::connect(boost::asio::ip::tcp::resolver::results_type const& endpoints, ConnectHandler const& handler) {
+    std::vector<Endpoint> generic_endpoints;
+    for (auto const& entry : endpoints) {
+        generic_endpoints.emplace_back(entry.endpoint());
+    }
+    connect(std::move(generic_endpoints), handler);
+}
+
+void TCPClient::connect(std::vector<Endpoint> endpoints, ConnectHandler const& handler) {
+    if (connected_) {
+        disconnect();
+    }
 
-                    start_read();
-                    handler(true);
-                } else {
-                    log_error("Connection error: " + error.message());
-                    handler(false);
+    // Kept for reconnection, which retries the same endpoints without resolving again
+    endpoints_ = std::move(endpoints);
+    reconnecting_ = false;
+    reconnect_timer_.cancel();
+    reconnect_delay_ = reconnect_policy_.initial_delay;
+    if (!connected_ && socket_->is_open()) {
+        // Abandon an automatic attempt still in progress
+        boost::system::error_code ec;
+        std::ignore = socket_->close(ec);
+    }
+
+    boost::asio::async_connect(*socket_, endpoints_,
+        [this, handler](boost::system::error_code const& error, Endpoint const& /*endpoint*/) {
+            if (!error) {
+                handle_connected(false);
+                handler(true);
+            } else {
+                log_error("Connection error: " + error.message());
+                handler(false);
+                if (reconnect_policy_.enabled && error != boost::asio::error::operation_aborted) {
+                    schedule_reconnect();
+                }
+            }
+        });
+}
+
+void TCPClient::handle_connected(bool restored) {
+    connected_ = true;
+    reconnect_delay_ = reconnect_policy_.initial_delay;
+    frame_reader_.reset();
+    apply_socket_options(*socket_, socket_options_);
+    auto const remote = socket_->remote_endpoint();
+    quick_ack_ = socket_options_.quick_ack.value_or(false) && remote.protocol().family() != AF_UNIX;
+    log_info(std::string(restored ? "Reconnected" : "Connected") + " to server at " + endpoint_string(remote));
+
+    start_read();
+
+    // Session state first, then whatever was sent while offline
+    if (restored) {
+        restore_handler_();
+    }
+    write_queue_.take_pending_from(offline_queue_);
+    flush();
+}
+
+void TCPClient::schedule_reconnect() {
+    reconnecting_ = true;
+
+    // Jittered exponential backoff
+    auto const delay = reconnect_delay_.count();
+    std::uniform_int_distribution<long long> distribution(
+        static_cast<long long>(static_cast<double>(delay) * (1.0 - reconnect_policy_.jitter)), delay);
+    reconnect_timer_.expires_after(std::chrono::milliseconds(distribution(jitter_engine_)));
+    reconnect_delay_ = std::min(reconnect_policy_.max_delay,
+        std::chrono::milliseconds(static_cast<long long>(static_cast<double>(delay) * reconnect_policy_.multiplier)));
+
+    reconnect_timer_.async_wait([this](boost::system::error_code const& error) {
+        if (error || !reconnecting_) {
+            return;
+        }
+        ++reconnect_attempts_;
+        // Same socket object; async_connect reopens it for each endpoint it tries
+        boost::asio::async_connect(*socket_, endpoints_,
+            [this](boost::system::error_code const& connect_error, Endpoint const& /*endpoint*/) {
+                if (!reconnecting_) {
+                    return;
                 }
+                if (connect_error) {
+                    schedule_reconnect();
+                    return;
+                }
+                reconnecting_ = false;
+                handle_connected(true);
             });
-    } catch (std::exception const& e) {
-        log_error("Resolve error: " + std::string(e.what()));
-        handler(false);
+    });
+}
+
+void TCPClient::close_socket() {
+    boost::system::error_code ec;
+    std::ignore = socket_->shutdown(boost::asio::socket_base::shutdown_both, ec);
+    std::ignore = socket_->close(ec);
+    connected_ = false;
+}
+
+void TCPClient::handle_connection_lost() {
+    if (!connected_) {
+        return;
     }
+    close_socket();
+    log_info("Disconnected from server");
+
+    if (reconnect_policy_.enabled && !endpoints_.empty()) {
+        // Unsent messages wait in the offline queue; what was already written is not replayed
+        offline_queue_.take_pending_from(write_queue_);
+        offline_dropped_ += offline_queue_.trim(reconnect_policy_.offline_queue_bytes);
+        schedule_reconnect();
+    } else {
+        write_queue_.clear();
+    }
+
+    // May call disconnect(), which cancels the reconnection scheduled above
+    disconnect_handler_();
 }
 
 void TCPClient::disconnect() {
-    if (connected_ && socket_->is_open()) {
-        boost::system::error_code ec;
-        std::ignore = socket_->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
-        std::ignore = socket_->close(ec);
-        connected_ = false;
+    bool const was_connected = connected_ && socket_->is_open();
+    reconnecting_ = false;
+    reconnect_timer_.cancel();
+    offline_queue_.clear();
+    if (was_connected) {
+        close_socket();
+        write_queue_.clear();
         log_info("Disconnected from server");
         disconnect_handler_();
+    } else if (socket_->is_open()) {
+        // Abort a connection attempt in progress
+        boost::system::error_code ec;
+        std::ignore = socket_->close(ec);
     }
 }
 
@@ -64,22 +212,67 @@ bool TCPClient::is_connected() const {
     return connected_ && socket_->is_open();
 }
 
-void TCPClient::send_data(uint8_t const* data, std::size_t length) {
+void TCPClient::set_reconnect_policy(ReconnectPolicy const& policy) {
+    reconnect_policy_ = policy;
+    // Beyond 1 the lower bound of the delay would go negative
+    reconnect_policy_.jitter = std::clamp(policy.jitter, 0.0, 1.0);
+    reconnect_delay_ = policy.initial_delay;
+}
+
+bool TCPClient::is_reconnecting() const {
+    return reconnecting_;
+}
+
+uint64_t TCPClient::reconnect_attempts() const {
+    return reconnect_attempts_;
+}
+
+uint64_t TCPClient::offline_dropped() const {
+    return offline_dropped_;
+}
+
+void TCPClient::send_data(uint8_t const* data, std::size_t length, Priority priority) {
     if (!is_connected()) {
-        log_error("Cannot send: not connected");
+        if (!reconnect_policy_.enabled) {
+            log_error("Cannot send: not connected");
+            return;
+        }
+        if (offline_queue_.queued_bytes() + length > reconnect_policy_.offline_queue_bytes) {
+            ++offline_dropped_;
+            return;
+        }
+        offline_queue_.push(data, length, priority);
         return;
     }
+    if (write_queue_.push(data, length, priority)) {
+        flush();
+    }
+}
 
+void TCPClient::flush() {
+    if (write_queue_.writing() || write_queue_.empty()) {
+        return;
+    }
     boost::asio::async_write(*socket_,
-        boost::asio::buffer(data, length),
+        write_queue_.begin_batch(),
         [this](boost::system::error_code const& error, std::size_t /*bytes_transferred*/) {
+            write_queue_.end_batch();
+            if (error == boost::asio::error::operation_aborted) {
+                // Write cancelled by a close; pick up anything queued on a newer connection
+                if (is_connected()) {
+                    flush();
+                }
+                return;
+            }
             if (error) {
                 log_error("Send error: " + error.message());
                 if (error == boost::asio::error::connection_reset ||
                     error == boost::asio::error::broken_pipe) {
-                    disconnect();
+                    handle_connection_lost();
                 }
+                return;
             }
+            flush();
         });
 }
 
@@ -91,11 +284,26 @@ void TCPClient::set_disconnect_handler(DisconnectHandler handler) {
     disconnect_handler_ = std::move(handler);
 }
 
+void TCPClient::set_restore_handler(RestoreHandler handler) {
+    restore_handler_ = std::move(handler);
+}
+
 void TCPClient::start_read() {
     if (!is_connected()) {
         return;
     }
 
+#if defined(HOVERLINK_IO_URING)
+    if (registered_slot_) {
+        // Registered buffer: the kernel reads straight into pre-pinned memory
+        socket_->async_read_some(
+            buffer_pool_.buffer(*registered_slot_),
+            [this](boost::system::error_code const& error, std::size_t bytes_transferred) {
+                this->handle_read(error, bytes_transferred);
+            });
+        return;
+    }
+#endif
     socket_->async_read_some(
         boost::asio::buffer(recv_buffer_),
         [this](boost::system::error_code const& error, std::size_t bytes_transferred) {
@@ -106,18 +314,38 @@ void TCPClient::start_read() {
 void TCPClient::handle_read(boost::system::error_code const& error,
     std::size_t bytes_transferred) {
     if (!error) {
-        // Call the message handler with binary data for flatbuffer
-        message_handler_(recv_buffer_.data(), bytes_transferred);
+        uint8_t const* data = recv_buffer_.data();
+#if defined(HOVERLINK_IO_URING)
+        if (registered_slot_) {
+            data = buffer_pool_.data(*registered_slot_);
+        }
+#endif
+
+        // Reassemble framed messages and hand each complete one to the handler
+        bool const valid = frame_reader_.feed(data, bytes_transferred,
+            [this](uint8_t const* message, std::size_t size) {
+                message_handler_(message, size);
+            });
+        if (!valid) {
+            log_error("Malformed frame from server");
+            handle_connection_lost();
+            return;
+        }
+        if (quick_ack_ && is_connected()) {
+            rearm_quick_ack(*socket_);
+        }
 
         // Continue reading
         start_read();
+    } else if (error == boost::asio::error::operation_aborted) {
+        // Our own close; a reconnect may already have started a new read
     } else if (error == boost::asio::error::eof ||
                error == boost::asio::error::connection_reset) {
         log_info("Server disconnected");
-        disconnect();
+        handle_connection_lost();
     } else {
         log_error("Read error: " + error.message());
-        disconnect();
+        handle_connection_lost();
     }
 }
 } // namespace network
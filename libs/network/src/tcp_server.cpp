@@ -1,43 +1,75 @@
 #include "network/tcp_server.hpp"
 #include <iostream>
+#include <stdexcept>
 
 namespace network {
 // TCPConnection implementation
-TCPConnection::TCPConnection(boost::asio::ip::tcp::socket socket)
+TCPConnection::TCPConnection(Socket socket, SocketOptions const& socket_options)
     : socket_(std::move(socket)),
+      quick_ack_(socket_options.quick_ack.value_or(false) && socket_.is_open()
+                 && socket_.local_endpoint().protocol().family() != AF_UNIX),
       message_handler_([](uint8_t const*, std::size_t, std::shared_ptr<TCPConnection>) {
       }),
       disconnect_handler_([](std::shared_ptr<TCPConnection>) {
       }) {
+    if (socket_.is_open()) {
+        apply_socket_options(socket_, socket_options);
+    }
+#if defined(HOVERLINK_IO_URING)
+    buffer_pool_ = &boost::asio::use_service<RegisteredBufferPool>(
+        boost::asio::query(socket_.get_executor(), boost::asio::execution::context));
+    registered_slot_ = buffer_pool_->acquire();
+#endif
+}
+
+TCPConnection::~TCPConnection() {
+#if defined(HOVERLINK_IO_URING)
+    if (registered_slot_) {
+        buffer_pool_->release(*registered_slot_);
+    }
+#endif
 }
 
 void TCPConnection::start() {
     start_read();
 }
 
-void TCPConnection::send_data(uint8_t const* data, std::size_t length) {
+void TCPConnection::send_data(uint8_t const* data, std::size_t length, Priority priority) {
     if (!socket_.is_open()) {
         return;
     }
+    if (write_queue_.push(data, length, priority)) {
+        flush();
+    }
+}
+
+void TCPConnection::flush() {
+    if (write_queue_.writing() || write_queue_.empty()) {
+        return;
+    }
     auto self = shared_from_this();
     boost::asio::async_write(socket_,
-        boost::asio::buffer(data, length),
-        [this](boost::system::error_code const& error, auto) {
+        write_queue_.begin_batch(),
+        [this, self](boost::system::error_code const& error, std::size_t /*bytes_transferred*/) {
+            write_queue_.end_batch();
             if (error) {
                 log_error("Send error: " + error.message());
                 if (error == boost::asio::error::connection_reset ||
                     error == boost::asio::error::broken_pipe) {
                     close();
                 }
+                return;
             }
+            flush();
         });
 }
 
 void TCPConnection::close() {
     if (socket_.is_open()) {
         boost::system::error_code ec;
-        std::ignore = socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        std::ignore = socket_.shutdown(Socket::shutdown_both, ec);
         std::ignore = socket_.close(ec);
+        write_queue_.clear();
         auto self = shared_from_this();
         disconnect_handler_(self);
     }
@@ -45,15 +77,14 @@ void TCPConnection::close() {
 
 std::string TCPConnection::get_endpoint_string() const {
     try {
-        auto endpoint = socket_.remote_endpoint();
-        return endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+        return endpoint_string(socket_.remote_endpoint());
     } catch (std::exception const&) {
         return "unknown";
     }
 }
 
 boost::asio::ip::tcp::endpoint TCPConnection::get_endpoint() const {
-    return socket_.remote_endpoint();
+    return to_tcp_endpoint(socket_.remote_endpoint()).value_or(boost::asio::ip::tcp::endpoint());
 }
 
 void TCPConnection::set_message_handler(MessageHandler handler) {
@@ -66,9 +97,20 @@ void TCPConnection::set_disconnect_handler(DisconnectHandler handler) {
 
 void TCPConnection::start_read() {
     auto self = shared_from_this();
+#if defined(HOVERLINK_IO_URING)
+    if (registered_slot_) {
+        // Registered buffer: the kernel reads straight into pre-pinned memory
+        socket_.async_read_some(
+            buffer_pool_->buffer(*registered_slot_),
+            [this, self](boost::system::error_code const& error, std::size_t bytes_transferred) {
+                this->handle_read(error, bytes_transferred);
+            });
+        return;
+    }
+#endif
     socket_.async_read_some(
         boost::asio::buffer(recv_buffer_),
-        [this](boost::system::error_code const& error, std::size_t bytes_transferred) {
+        [this, self](boost::system::error_code const& error, std::size_t bytes_transferred) {
             this->handle_read(error, bytes_transferred);
         });
 }
@@ -78,8 +120,26 @@ void TCPConnection::handle_read(boost::system::error_code const& error,
     if (!error) {
         auto self = shared_from_this();
 
-        // Call the message handler with binary data for flatbuffer
-        message_handler_(recv_buffer_.data(), bytes_transferred, self);
+        uint8_t const* data = recv_buffer_.data();
+#if defined(HOVERLINK_IO_URING)
+        if (registered_slot_) {
+            data = buffer_pool_->data(*registered_slot_);
+        }
+#endif
+
+        // Reassemble framed messages and hand each complete one to the handler
+        bool const valid = frame_reader_.feed(data, bytes_transferred,
+            [this, &self](uint8_t const* message, std::size_t size) {
+                message_handler_(message, size, self);
+            });
+        if (!valid) {
+            log_error("Malformed frame from " + get_endpoint_string());
+            close();
+            return;
+        }
+        if (quick_ack_ && socket_.is_open()) {
+            rearm_quick_ack(socket_);
+        }
 
         // Continue reading
         start_read();
@@ -94,13 +154,53 @@ void TCPConnection::handle_read(boost::system::error_code const& error,
 }
 
 // TCPServer implementation
-TCPServer::TCPServer(boost::asio::io_context& io_context, int port)
+TCPServer::TCPServer(boost::asio::io_context& io_context, int port, SocketOptions socket_options)
+    : TCPServer(io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port),
+                std::move(socket_options)) {
+}
+
+TCPServer::TCPServer(boost::asio::io_context& io_context, std::string const& address, SocketOptions socket_options)
+    : TCPServer(io_context, make_listen_endpoint(address), std::move(socket_options)) {
+}
+
+TCPServer::TCPServer(boost::asio::io_context& io_context,
+    boost::asio::generic::stream_protocol::endpoint const& endpoint, SocketOptions socket_options)
     : io_context_(io_context),
-      acceptor_(io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)),
+      acceptor_(io_context, endpoint),
+      socket_options_(std::move(socket_options)),
       running_(false),
       connection_handler_([](std::shared_ptr<TCPConnection>) {
       }) {
-    log_info("TCP server initialized on port " + std::to_string(port));
+    if (auto const local = to_local_endpoint(endpoint)) {
+        socket_file_ = bound_socket_file(socket_file_path(*local));
+    }
+    apply_socket_options(acceptor_, socket_options_);
+    log_info("TCP server initialized on " + get_local_address());
+}
+
+TCPServer::~TCPServer() {
+    remove_socket_file(socket_file_);
+}
+
+boost::asio::generic::stream_protocol::endpoint TCPServer::make_listen_endpoint(std::string const& address) {
+    if (auto const local = parse_local_address<boost::asio::local::stream_protocol>(address)) {
+        // A socket file outlives a crashed server and would make bind fail
+        remove_stale_socket_file(socket_file_path(*local), SOCK_STREAM);
+        return *local;
+    }
+    auto const host_port = parse_host_port(address);
+    if (!host_port) {
+        throw std::invalid_argument("Invalid listen address: " + address);
+    }
+    if (host_port->host.empty()) {
+        return boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), static_cast<unsigned short>(host_port->port));
+    }
+    boost::system::error_code ec;
+    auto const ip = boost::asio::ip::make_address(host_port->host, ec);
+    if (ec) {
+        throw std::invalid_argument("Invalid listen address: " + address);
+    }
+    return boost::asio::ip::tcp::endpoint(ip, static_cast<unsigned short>(host_port->port));
 }
 
 void TCPServer::start() {
@@ -116,19 +216,23 @@ void TCPServer::stop() {
         running_ = false;
         acceptor_.close();
 
-        // Close all connections
-        for (auto& connection : connections_) {
+        // Close all connections. close() calls back into handle_client_disconnect,
+        // so iterate over a detached copy of the set
+        auto const connections = std::move(connections_);
+        connections_.clear();
+        for (auto const& connection : connections) {
             connection->close();
         }
-        connections_.clear();
+        remove_socket_file(socket_file_);
+        socket_file_.reset();
 
         log_info("TCP server stopped");
     }
 }
 
-void TCPServer::broadcast(uint8_t const* data, std::size_t length) const {
+void TCPServer::broadcast(uint8_t const* data, std::size_t length, Priority priority) const {
     for (auto& connection : connections_) {
-        connection->send_data(data, length);
+        connection->send_data(data, length, priority);
     }
 }
 
@@ -136,14 +240,23 @@ std::size_t TCPServer::connection_count() const {
     return connections_.size();
 }
 
+int TCPServer::get_local_port() const {
+    auto const endpoint = to_tcp_endpoint(acceptor_.local_endpoint());
+    return endpoint ? endpoint->port() : 0;
+}
+
+std::string TCPServer::get_local_address() const {
+    return endpoint_string(acceptor_.local_endpoint());
+}
+
 void TCPServer::set_connection_handler(ConnectionHandler handler) {
     connection_handler_ = std::move(handler);
 }
 
 void TCPServer::start_accept() {
     acceptor_.async_accept(
-        [this](boost::system::error_code const& error, boost::asio::ip::tcp::socket socket) {
-            auto connection = std::make_shared<TCPConnection>(std::move(socket));
+        [this](boost::system::error_code const& error, TCPConnection::Socket socket) {
+            auto connection = std::make_shared<TCPConnection>(std::move(socket), socket_options_);
             this->handle_accept(connection, error);
         });
 }
@@ -1,75 +1,249 @@
 #include "network/udp_client.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+
+#if defined(__linux__)
+    #include <linux/errqueue.h>
+    #include <linux/net_tstamp.h>
+    #include <sys/socket.h>
+#endif
 
 namespace network {
-UDPClient::UDPClient(boost::asio::io_context& io_context, int local_port)
+template <typename Protocol>
+DatagramClient<Protocol>::DatagramClient(boost::asio::io_context& io_context, int local_port,
+    SocketOptions const& socket_options)
+    requires is_ip_datagram_v<Protocol>
     : io_context_(io_context),
-      socket_(io_context, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), local_port)),
+      socket_(io_context, Endpoint(boost::asio::ip::udp::v4(), local_port)),
+      endpoint_cache_(io_context),
       running_(false),
-      message_handler_([](uint8_t const*, std::size_t, boost::asio::ip::udp::endpoint const&) {
+      connected_(false),
+      timestamping_(ReceiveTimestamping::Disabled),
+      message_handler_([](uint8_t const*, std::size_t, Endpoint const&) {
       }) {
+    apply_socket_options(socket_, socket_options);
     log_info("UDP client initialized on local port " + std::to_string(get_local_port()));
 }
 
-UDPClient::~UDPClient() {
+template <typename Protocol>
+DatagramClient<Protocol>::DatagramClient(boost::asio::io_context& io_context, std::string const& address,
+    SocketOptions const& socket_options)
+    requires (!is_ip_datagram_v<Protocol>)
+    : io_context_(io_context),
+      socket_(io_context),
+      endpoint_cache_(io_context),
+      running_(false),
+      connected_(false),
+      timestamping_(ReceiveTimestamping::Disabled),
+      message_handler_([](uint8_t const*, std::size_t, Endpoint const&) {
+      }) {
+    // An empty endpoint binds with no path, which Linux answers with an abstract name
+    auto const endpoint = address.empty() ? std::optional<Endpoint>(Endpoint())
+                                          : parse_local_address<Protocol>(address);
+    if (!endpoint) {
+        throw std::invalid_argument("Invalid local address: " + address);
+    }
+    auto const path = socket_file_path(*endpoint);
+    remove_stale_socket_file(path, SOCK_DGRAM);
+
+    socket_.open();
+    socket_.bind(*endpoint);
+    socket_file_ = bound_socket_file(path);
+    apply_socket_options(socket_, socket_options);
+    log_info("Unix datagram client initialized on " + get_local_address());
+}
+
+template <typename Protocol>
+DatagramClient<Protocol>::~DatagramClient() {
     stop();
+    remove_socket_file(socket_file_);
 }
 
-void UDPClient::start() {
+template <typename Protocol>
+void DatagramClient<Protocol>::start() {
     if (!running_) {
         running_ = true;
-        start_receive();
-        log_info("UDP client started");
+        if (timestamping_ == ReceiveTimestamping::Disabled) {
+            start_receive();
+        } else {
+            start_timestamped_receive();
+        }
+        log_info(std::string(NAME) + " client started");
     }
 }
 
-void UDPClient::stop() {
+template <typename Protocol>
+void DatagramClient<Protocol>::stop() {
     if (running_) {
         running_ = false;
+        connected_ = false;
+        endpoint_cache_.clear();
         boost::system::error_code ec;
         std::ignore = socket_.close(ec);
-        log_info("UDP client stopped");
+        log_info(std::string(NAME) + " client stopped");
     }
 }
 
-void UDPClient::send_data(uint8_t const* data, std::size_t length,
-    boost::asio::ip::udp::endpoint const& endpoint) {
+template <typename Protocol>
+void DatagramClient<Protocol>::send_data(uint8_t const* data, std::size_t length,
+    Endpoint const& endpoint) {
     socket_.async_send_to(
         boost::asio::buffer(data, length),
         endpoint,
         [](boost::system::error_code const& error, std::size_t /*bytes_sent*/) {
             if (error) {
-                log_error("Failed to send UDP data: " + error.message());
+                log_error(std::string("Failed to send ") + NAME + " data: " + error.message());
             }
         });
 }
 
-void UDPClient::send_data(uint8_t const* data, std::size_t length,
-    std::string const& host, int port) {
-    try {
-        boost::asio::ip::udp::resolver resolver(io_context_);
-        auto endpoints = resolver.resolve(host, std::to_string(port));
+template <typename Protocol>
+void DatagramClient<Protocol>::send_data(std::vector<uint8_t> data, Endpoint const& endpoint) {
+    // The buffer points at the vector's heap storage, which stays put when the
+    // vector is moved into the completion handler
+    auto const buffer = boost::asio::buffer(data);
+    socket_.async_send_to(
+        buffer,
+        endpoint,
+        [data = std::move(data)](boost::system::error_code const& error, std::size_t /*bytes_sent*/) {
+            if (error) {
+                log_error(std::string("Failed to send ") + NAME + " data: " + error.message());
+            }
+        });
+}
 
-        if (endpoints.begin() != endpoints.end()) {
-            auto endpoint = *endpoints.begin();
-            send_data(data, length, endpoint.endpoint());
-        } else {
-            log_error("Could not resolve host: " + host);
-        }
-    } catch (std::exception const& e) {
-        log_error("Error resolving host: " + std::string(e.what()));
+template <typename Protocol>
+void DatagramClient<Protocol>::send_data(uint8_t const* data, std::size_t length,
+    std::string const& host, int port)
+    requires is_ip_datagram_v<Protocol> {
+    if (auto const endpoint = endpoint_cache_.lookup(host, port)) {
+        send_data(data, length, *endpoint);
+        return;
+    }
+
+    // First send to this host: the caller's buffer may be gone by the time the
+    // resolver answers, so keep a copy until then
+    auto payload = std::make_shared<std::vector<uint8_t>>(data, data + length);
+    endpoint_cache_.resolve(host, port,
+        [this, payload, host](std::optional<Endpoint> const& endpoint) {
+            if (!endpoint) {
+                log_error("Could not resolve host: " + host);
+                return;
+            }
+            socket_.async_send_to(
+                boost::asio::buffer(*payload),
+                *endpoint,
+                [payload](boost::system::error_code const& error, std::size_t /*bytes_sent*/) {
+                    if (error) {
+                        log_error(std::string("Failed to send ") + NAME + " data: " + error.message());
+                    }
+                });
+        });
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::connect(std::string const& host, int port, ConnectHandler const& handler)
+    requires is_ip_datagram_v<Protocol> {
+    endpoint_cache_.resolve(host, port,
+        [this, host, handler](std::optional<Endpoint> const& endpoint) {
+            if (!endpoint) {
+                log_error("Could not resolve host: " + host);
+                handler(false);
+                return;
+            }
+            connect(*endpoint);
+            handler(connected_);
+        });
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::connect(Endpoint const& endpoint) {
+    boost::system::error_code ec;
+    std::ignore = socket_.connect(endpoint, ec);
+    if (ec) {
+        log_error(std::string(NAME) + " connect error: " + ec.message());
+        connected_ = false;
+        return;
+    }
+    connected_ = true;
+    log_info(std::string(NAME) + " client connected to " + endpoint_string(endpoint));
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::disconnect() {
+    if (!connected_) {
+        return;
+    }
+    // Connecting to an AF_UNSPEC address dissolves the association
+    sockaddr unspecified{};
+    unspecified.sa_family = AF_UNSPEC;
+    std::ignore = ::connect(socket_.native_handle(), &unspecified, sizeof(unspecified));
+    connected_ = false;
+}
+
+template <typename Protocol>
+bool DatagramClient<Protocol>::is_connected() const {
+    return connected_;
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::send(uint8_t const* data, std::size_t length) {
+    if (!connected_) {
+        log_error(std::string("Cannot send: ") + NAME + " client not connected");
+        return;
     }
+    socket_.async_send(
+        boost::asio::buffer(data, length),
+        [](boost::system::error_code const& error, std::size_t /*bytes_sent*/) {
+            if (error) {
+                log_error(std::string("Failed to send ") + NAME + " data: " + error.message());
+            }
+        });
 }
 
-void UDPClient::set_message_handler(MessageHandler handler) {
+template <typename Protocol>
+void DatagramClient<Protocol>::send(std::vector<uint8_t> data) {
+    if (!connected_) {
+        log_error(std::string("Cannot send: ") + NAME + " client not connected");
+        return;
+    }
+    auto const buffer = boost::asio::buffer(data);
+    socket_.async_send(
+        buffer,
+        [data = std::move(data)](boost::system::error_code const& error, std::size_t /*bytes_sent*/) {
+            if (error) {
+                log_error(std::string("Failed to send ") + NAME + " data: " + error.message());
+            }
+        });
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::set_resolve_ttl(std::chrono::steady_clock::duration ttl)
+    requires is_ip_datagram_v<Protocol> {
+    endpoint_cache_.set_ttl(ttl);
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::set_message_handler(MessageHandler handler) {
     message_handler_ = std::move(handler);
 }
 
-int UDPClient::get_local_port() const {
+template <typename Protocol>
+int DatagramClient<Protocol>::get_local_port() const
+    requires is_ip_datagram_v<Protocol> {
     return socket_.local_endpoint().port();
 }
 
-void UDPClient::start_receive() {
+template <typename Protocol>
+std::string DatagramClient<Protocol>::get_local_address() const {
+    return endpoint_string(socket_.local_endpoint());
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::start_receive() {
     socket_.async_receive_from(
         boost::asio::buffer(recv_buffer_),
         remote_endpoint_,
@@ -78,13 +252,14 @@ void UDPClient::start_receive() {
         });
 }
 
-void UDPClient::handle_receive(boost::system::error_code const& error,
+template <typename Protocol>
+void DatagramClient<Protocol>::handle_receive(boost::system::error_code const& error,
     std::size_t bytes_transferred) {
     if (!error) {
         // Call the message handler with binary data
         message_handler_(recv_buffer_.data(), bytes_transferred, remote_endpoint_);
     } else if (error != boost::asio::error::operation_aborted) {
-        log_error("UDP receive error: " + error.message());
+        log_error(std::string(NAME) + " receive error: " + error.message());
     }
 
     // Continue receiving if still running
@@ -92,4 +267,144 @@ void UDPClient::handle_receive(boost::system::error_code const& error,
         start_receive();
     }
 }
+
+template <typename Protocol>
+bool DatagramClient<Protocol>::enable_receive_timestamps(ReceiveTimestamping mode) {
+    if (running_) {
+        log_error("Receive timestamping must be configured before start()");
+        return false;
+    }
+#if defined(__linux__)
+    int result = 0;
+    if (mode == ReceiveTimestamping::Software) {
+        int const on = 1;
+        result = ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+    } else if (mode == ReceiveTimestamping::Hardware) {
+        // Hardware stamping also needs SIOCSHWTSTAMP on the interface, which is
+        // a privileged, system-wide setting left to deployment tooling
+        int const flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+                          | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        result = ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+    }
+    if (result != 0) {
+        log_error(std::string("Failed to enable ") + NAME + " receive timestamps: " + std::strerror(errno));
+        return false;
+    }
+    timestamping_ = mode;
+    return true;
+#else
+    if (mode != ReceiveTimestamping::Disabled) {
+        log_error(std::string(NAME) + " receive timestamps are not supported on this platform");
+        return false;
+    }
+    return true;
+#endif
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::set_timestamped_message_handler(TimestampedMessageHandler handler) {
+    timestamped_handler_ = std::move(handler);
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::start_timestamped_receive() {
+    // Wait for readability and then read with recvmsg ourselves, which is the
+    // only way to get at the ancillary data carrying the timestamp
+    socket_.async_wait(Protocol::socket::wait_read,
+        [this](boost::system::error_code const& error) {
+            if (error) {
+                if (error != boost::asio::error::operation_aborted) {
+                    log_error(std::string(NAME) + " receive error: " + error.message());
+                }
+            } else {
+                drain_timestamped();
+            }
+
+            // Continue receiving if still running
+            if (running_) {
+                start_timestamped_receive();
+            }
+        });
+}
+
+template <typename Protocol>
+void DatagramClient<Protocol>::drain_timestamped() {
+#if defined(__linux__)
+    alignas(cmsghdr) std::array<char, 256> control{};
+
+    // Read what is already queued, up to a batch, before re-arming the wait
+    std::size_t datagrams = 0;
+    while (running_ && datagrams < MAX_DATAGRAMS_PER_WAKEUP) {
+        iovec iov{recv_buffer_.data(), recv_buffer_.size()};
+        msghdr msg{};
+        msg.msg_name = remote_endpoint_.data();
+        msg.msg_namelen = static_cast<socklen_t>(remote_endpoint_.capacity());
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+
+        auto const received = ::recvmsg(socket_.native_handle(), &msg, MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                log_error(std::string(NAME) + " recvmsg error: " + std::string(std::strerror(errno)));
+            }
+            if (errno != EINTR) {
+                return;
+            }
+            continue;
+        }
+        ++datagrams;
+        remote_endpoint_.resize(msg.msg_namelen);
+        if (msg.msg_flags & MSG_TRUNC) {
+            log_error(std::string(NAME) + " datagram larger than the receive buffer dropped");
+            continue;
+        }
+
+        ReceiveInfo info{};
+        info.dispatch_time = std::chrono::system_clock::now();
+
+        auto const to_duration = [](timespec const& ts) {
+            return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+        };
+        // A truncated control buffer may hold a partial timestamp: treat it as missing
+        auto* first = (msg.msg_flags & MSG_CTRUNC) ? nullptr : CMSG_FIRSTHDR(&msg);
+        for (auto* cmsg = first; cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts{};
+                std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                info.kernel_time = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(to_duration(ts)));
+            } else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                scm_timestamping stamps{};
+                std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+                // ts[0] is the software stamp, ts[2] the raw hardware stamp
+                if (stamps.ts[0].tv_sec != 0 || stamps.ts[0].tv_nsec != 0) {
+                    info.kernel_time = std::chrono::system_clock::time_point(
+                        std::chrono::duration_cast<std::chrono::system_clock::duration>(to_duration(stamps.ts[0])));
+                }
+                if (stamps.ts[2].tv_sec != 0 || stamps.ts[2].tv_nsec != 0) {
+                    info.hardware_time = to_duration(stamps.ts[2]);
+                }
+            }
+        }
+        if (info.kernel_time) {
+            info.queue_latency = info.dispatch_time - *info.kernel_time;
+        }
+
+        auto const length = static_cast<std::size_t>(received);
+        if (timestamped_handler_) {
+            timestamped_handler_(recv_buffer_.data(), length, remote_endpoint_, info);
+        } else {
+            message_handler_(recv_buffer_.data(), length, remote_endpoint_);
+        }
+    }
+#endif
+}
+
+template class DatagramClient<boost::asio::ip::udp>;
+template class DatagramClient<boost::asio::local::datagram_protocol>;
 } // namespace network
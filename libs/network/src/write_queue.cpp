@@ -0,0 +1,148 @@
+#include "network/write_queue.hpp"
+#include <algorithm>
+#include "network/common.hpp"
+
+namespace network {
+namespace {
+// Keep a few buffers around for reuse, but don't hoard memory after a burst
+constexpr std::size_t MAX_SPARE_BUFFERS = 64;
+} // namespace
+
+bool WriteQueue::push(uint8_t const* data, std::size_t length, Priority priority) {
+    if (length > MAX_MESSAGE_SIZE) {
+        log_error("Message of " + std::to_string(length) + " bytes exceeds the " +
+                  std::to_string(MAX_MESSAGE_SIZE) + " byte limit, not sent");
+        return false;
+    }
+    auto buffer = take_spare();
+    buffer.assign(data, data + length);
+    lanes_[static_cast<std::size_t>(priority)].messages.push_back(std::move(buffer));
+    queued_bytes_ += length;
+    return true;
+}
+
+bool WriteQueue::empty() const {
+    return std::all_of(lanes_.begin(), lanes_.end(), [](Lane const& lane) {
+        return lane.messages.empty();
+    });
+}
+
+bool WriteQueue::writing() const {
+    return writing_;
+}
+
+std::size_t WriteQueue::queued_bytes() const {
+    return queued_bytes_;
+}
+
+std::vector<boost::asio::const_buffer> const& WriteQueue::begin_batch() {
+    writing_ = true;
+    gather_.clear();
+
+    std::size_t chunks = 0;
+    std::size_t batch_bytes = 0;
+    for (std::size_t index = 0; index < PRIORITY_COUNT; ++index) {
+        auto& lane = lanes_[index];
+        // Always take at least one chunk
+        while (!lane.messages.empty() && chunks < MAX_BATCH_CHUNKS
+               && (chunks == 0 || batch_bytes < MAX_BATCH_BYTES)) {
+            auto& message = lane.messages.front();
+            auto const size = std::min(FRAME_CHUNK_SIZE, message.size() - lane.offset);
+            bool const final = lane.offset + size == message.size();
+
+            auto& header = headers_[chunks];
+            encode_frame_header(header.data(), {static_cast<Priority>(index), final, static_cast<uint16_t>(size)});
+            gather_.emplace_back(header.data(), header.size());
+            gather_.emplace_back(message.data() + lane.offset, size);
+            ++chunks;
+            batch_bytes += size;
+
+            if (final) {
+                // Moving the vector keeps its storage, so the gather entry stays valid
+                in_flight_.push_back(std::move(message));
+                lane.messages.pop_front();
+                lane.offset = 0;
+            } else {
+                lane.offset += size;
+            }
+        }
+    }
+    queued_bytes_ -= batch_bytes;
+    return gather_;
+}
+
+void WriteQueue::end_batch() {
+    for (auto& message : in_flight_) {
+        if (spare_.size() < MAX_SPARE_BUFFERS) {
+            message.clear();
+            spare_.push_back(std::move(message));
+        }
+    }
+    in_flight_.clear();
+    gather_.clear();
+    writing_ = false;
+}
+
+void WriteQueue::clear() {
+    for (auto& lane : lanes_) {
+        // A partly sent message may still be referenced by the write in flight
+        if (writing_ && lane.offset > 0) {
+            in_flight_.push_back(std::move(lane.messages.front()));
+        }
+        lane.messages.clear();
+        lane.offset = 0;
+    }
+    queued_bytes_ = 0;
+}
+
+void WriteQueue::take_pending_from(WriteQueue& other) {
+    for (std::size_t index = 0; index < PRIORITY_COUNT; ++index) {
+        auto& from = other.lanes_[index];
+        auto& to = lanes_[index].messages;
+        for (auto& message : from.messages) {
+            queued_bytes_ += message.size();
+            if (other.writing_ && from.offset > 0 && &message == &from.messages.front()) {
+                // The other queue's write may still read the partly sent front
+                // message until it completes, so that one stays with its batch
+                // and this queue gets a copy to send whole
+                auto copy = take_spare();
+                copy.assign(message.begin(), message.end());
+                to.push_back(std::move(copy));
+                other.in_flight_.push_back(std::move(message));
+            } else {
+                to.push_back(std::move(message));
+            }
+        }
+        from.messages.clear();
+        from.offset = 0;
+    }
+    other.queued_bytes_ = 0;
+}
+
+std::size_t WriteQueue::trim(std::size_t max_bytes) {
+    std::size_t dropped = 0;
+    for (auto lane = lanes_.rbegin(); lane != lanes_.rend() && queued_bytes_ > max_bytes; ++lane) {
+        while (!lane->messages.empty() && queued_bytes_ > max_bytes) {
+            auto& message = lane->messages.front();
+            queued_bytes_ -= message.size() - lane->offset;
+            // A partly sent message may still be referenced by the write in flight
+            if (writing_ && lane->offset > 0) {
+                in_flight_.push_back(std::move(message));
+            }
+            lane->messages.pop_front();
+            lane->offset = 0;
+            ++dropped;
+        }
+    }
+    return dropped;
+}
+
+std::vector<uint8_t> WriteQueue::take_spare() {
+    if (spare_.empty()) {
+        return {};
+    }
+    auto buffer = std::move(spare_.back());
+    spare_.pop_back();
+    return buffer;
+}
+} // namespace network
@@ -0,0 +1,60 @@
+// TCPServer::stop() with live connections: closing a connection calls back
+// into the server, which erases it from the set being iterated. Every client
+// must see its connection close, and the server must end up empty.
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <boost/asio.hpp>
+#include "network/tcp_client.hpp"
+#include "network/tcp_server.hpp"
+
+namespace {
+constexpr int CLIENT_COUNT = 8;
+
+int fail(char const* message) {
+    std::cerr << "FAIL: " << message << std::endl;
+    return 1;
+}
+} // namespace
+
+int main() {
+    boost::asio::io_context io_context;
+    network::TCPServer server(io_context, "127.0.0.1:0");
+    server.start();
+    auto const address = server.get_local_address();
+
+    int connected = 0;
+    int disconnected = 0;
+    std::vector<std::unique_ptr<network::TCPClient>> clients;
+    for (int i = 0; i < CLIENT_COUNT; ++i) {
+        clients.push_back(std::make_unique<network::TCPClient>(io_context));
+        clients.back()->set_disconnect_handler([&disconnected]() {
+            ++disconnected;
+        });
+        clients.back()->connect(address, [&connected](bool ok) {
+            connected += ok ? 1 : 0;
+        });
+    }
+
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (server.connection_count() < CLIENT_COUNT && std::chrono::steady_clock::now() < deadline) {
+        io_context.run_one_for(std::chrono::milliseconds(100));
+    }
+    if (connected != CLIENT_COUNT || server.connection_count() != CLIENT_COUNT) {
+        return fail("clients did not connect");
+    }
+
+    server.stop();
+    if (server.connection_count() != 0) {
+        return fail("connections left after stop()");
+    }
+
+    while (disconnected < CLIENT_COUNT && std::chrono::steady_clock::now() < deadline) {
+        io_context.run_one_for(std::chrono::milliseconds(100));
+    }
+    if (disconnected != CLIENT_COUNT) {
+        return fail("clients did not see the server close");
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "protocol/message_type.hpp"
+#include "protocol/messages.hpp"
+
+namespace protocol {
+// Parsed representation and parser for each message type
+template <MessageType Type>
+struct MessageTraits;
+
+template <>
+struct MessageTraits<MessageType::Command> {
+    using value_type = CommandMessage::Command;
+    static bool parse(uint8_t const* data, std::size_t size, value_type& value) {
+        return CommandMessage::parse(data, size, value);
+    }
+};
+
+template <>
+struct MessageTraits<MessageType::Status> {
+    using value_type = StatusMessage::StatusInfo;
+    static bool parse(uint8_t const* data, std::size_t size, value_type& value) {
+        return StatusMessage::parse(data, size, value);
+    }
+};
+
+template <>
+struct MessageTraits<MessageType::Telemetry> {
+    using value_type = TelemetryMessage::Telemetry;
+    static bool parse(uint8_t const* data, std::size_t size, value_type& value) {
+        return TelemetryMessage::parse(data, size, value);
+    }
+};
+
+template <>
+struct MessageTraits<MessageType::Control> {
+    using value_type = ControlMessage::Control;
+    static bool parse(uint8_t const* data, std::size_t size, value_type& value) {
+        return ControlMessage::parse(data, size, value);
+    }
+};
+
+enum class DispatchResult {
+    Handled,     // Verified, parsed and passed to a handler
+    Unhandled,   // Known type, but no handler accepts it
+    UnknownType, // No recognised file identifier, and no handled type verifies without one
+    Invalid      // Identifier matched but the buffer failed verification
+};
+
+// Routes frames of a mixed stream to typed handlers.
+//
+// Each handler is a callable taking one parsed message type, e.g.
+//     [](TelemetryMessage::Telemetry const& t) { ... }
+// For every MessageType the first handler invocable with its value_type is
+// selected at compile time, and a constexpr table of entry points is built
+// from that. dispatch() reads the file identifier, jumps through the table and
+// runs exactly one verifier, for the type the identifier names. A buffer with
+// no identifier (an older producer) is tried against each handled type in
+// MessageType order. Structure alone may not tell the types apart, so that is
+// only reliable on streams carrying one type, which is all older producers send.
+template <typename... Handlers>
+class Dispatcher {
+public:
+    explicit Dispatcher(Handlers... handlers)
+        : handlers_(std::move(handlers)...) {
+    }
+
+    DispatchResult dispatch(uint8_t const* data, std::size_t size) {
+        auto const type = identify(data, size);
+        return TABLE[static_cast<std::size_t>(type)](*this, data, size);
+    }
+
+    // Access a handler, e.g. to read state it accumulated
+    template <std::size_t Index>
+    auto& handler() {
+        return std::get<Index>(handlers_);
+    }
+
+    // Whether some handler accepts the given message type
+    static constexpr bool handles(MessageType type) {
+        return type != MessageType::Unknown && HANDLER_INDEX[static_cast<std::size_t>(type)] != NO_HANDLER;
+    }
+
+private:
+    using Entry = DispatchResult (*)(Dispatcher&, uint8_t const*, std::size_t);
+
+    static constexpr std::size_t NO_HANDLER = sizeof...(Handlers);
+
+    template <MessageType Type>
+    static constexpr std::size_t find_handler() {
+        if constexpr (Type == MessageType::Unknown) {
+            return NO_HANDLER;
+        } else {
+            using Value = typename MessageTraits<Type>::value_type;
+            constexpr std::array<bool, sizeof...(Handlers) + 1> accepts{
+                std::is_invocable_v<Handlers&, Value const&>..., true};
+            std::size_t index = 0;
+            while (!accepts[index]) {
+                ++index;
+            }
+            return index;
+        }
+    }
+
+    template <MessageType Type>
+    static DispatchResult invoke(Dispatcher& self, uint8_t const* data, std::size_t size) {
+        constexpr auto index = find_handler<Type>();
+        if constexpr (Type == MessageType::Unknown) {
+            return dispatch_untagged(self, data, size, std::make_index_sequence<MESSAGE_TYPE_COUNT>{})
+                       ? DispatchResult::Handled
+                       : DispatchResult::UnknownType;
+        } else if constexpr (index == NO_HANDLER) {
+            // Nobody wants it: skip verification entirely
+            return DispatchResult::Unhandled;
+        } else {
+            typename MessageTraits<Type>::value_type value{};
+            if (!MessageTraits<Type>::parse(data, size, value)) {
+                return DispatchResult::Invalid;
+            }
+            std::get<index>(self.handlers_)(std::as_const(value));
+            return DispatchResult::Handled;
+        }
+    }
+
+    // Trial verification for a buffer without an identifier; the first handled
+    // type it parses as wins
+    template <MessageType Type>
+    static bool try_untagged(Dispatcher& self, uint8_t const* data, std::size_t size) {
+        if constexpr (Type == MessageType::Unknown || find_handler<Type>() == NO_HANDLER) {
+            return false;
+        } else {
+            typename MessageTraits<Type>::value_type value{};
+            if (!MessageTraits<Type>::parse(data, size, value)) {
+                return false;
+            }
+            std::get<find_handler<Type>()>(self.handlers_)(std::as_const(value));
+            return true;
+        }
+    }
+
+    template <std::size_t... Types>
+    static bool dispatch_untagged(Dispatcher& self, uint8_t const* data, std::size_t size,
+        std::index_sequence<Types...>) {
+        return (try_untagged<static_cast<MessageType>(Types)>(self, data, size) || ...);
+    }
+
+    template <std::size_t... Types>
+    static constexpr std::array<Entry, MESSAGE_TYPE_COUNT> make_table(std::index_sequence<Types...>) {
+        return {&invoke<static_cast<MessageType>(Types)>...};
+    }
+
+    template <std::size_t... Types>
+    static constexpr std::array<std::size_t, MESSAGE_TYPE_COUNT> make_index(std::index_sequence<Types...>) {
+        return {find_handler<static_cast<MessageType>(Types)>()...};
+    }
+
+    static constexpr std::array<Entry, MESSAGE_TYPE_COUNT> TABLE =
+        make_table(std::make_index_sequence<MESSAGE_TYPE_COUNT>{});
+    static constexpr std::array<std::size_t, MESSAGE_TYPE_COUNT> HANDLER_INDEX =
+        make_index(std::make_index_sequence<MESSAGE_TYPE_COUNT>{});
+
+    std::tuple<Handlers...> handlers_;
+};
+} // namespace protocol
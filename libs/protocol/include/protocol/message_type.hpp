@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace protocol {
+// Message kinds that can share a stream. Values index the dispatch table.
+enum class MessageType : uint8_t {
+    Unknown,
+    Command,
+    Status,
+    Telemetry,
+    Control
+};
+
+constexpr std::size_t MESSAGE_TYPE_COUNT = 5;
+
+// FlatBuffers file identifiers (bytes 4-7 of every buffer). These must match
+// the file_identifier declarations in schemas/*.fbs.
+constexpr char COMMAND_IDENTIFIER[] = "FGCM";
+constexpr char STATUS_IDENTIFIER[] = "FGST";
+constexpr char TELEMETRY_IDENTIFIER[] = "FGTL";
+constexpr char CONTROL_IDENTIFIER[] = "FGCT";
+
+// Pack a 4-character identifier in wire byte order, independent of host endianness
+constexpr uint32_t pack_identifier(char const* id) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(id[0]))
+           | static_cast<uint32_t>(static_cast<uint8_t>(id[1])) << 8
+           | static_cast<uint32_t>(static_cast<uint8_t>(id[2])) << 16
+           | static_cast<uint32_t>(static_cast<uint8_t>(id[3])) << 24;
+}
+
+// Classify a buffer by its file identifier. This only looks at the header;
+// the buffer still has to be verified before use. Buffers from producers built
+// before the identifiers existed come out Unknown; the parsers still accept
+// them by verifying their structure alone.
+constexpr MessageType identify(uint8_t const* data, std::size_t size) {
+    // Root offset (4 bytes) followed by the identifier (4 bytes)
+    if (data == nullptr || size < 8) {
+        return MessageType::Unknown;
+    }
+    auto const id = static_cast<uint32_t>(data[4]) | static_cast<uint32_t>(data[5]) << 8
+                    | static_cast<uint32_t>(data[6]) << 16 | static_cast<uint32_t>(data[7]) << 24;
+    switch (id) {
+    case pack_identifier(COMMAND_IDENTIFIER):
+        return MessageType::Command;
+    case pack_identifier(STATUS_IDENTIFIER):
+        return MessageType::Status;
+    case pack_identifier(TELEMETRY_IDENTIFIER):
+        return MessageType::Telemetry;
+    case pack_identifier(CONTROL_IDENTIFIER):
+        return MessageType::Control;
+    default:
+        return MessageType::Unknown;
+    }
+}
+} // namespace protocol
@@ -37,6 +37,12 @@ public:
         std::vector<std::string> additional_args;
     };
 
+    // Parsed command: type plus optional configuration
+    struct Command {
+        Type type;
+        Config config;
+    };
+
     // Create command with type only
     static std::vector<uint8_t> create(Type type);
 
@@ -45,6 +51,7 @@ public:
 
     // Parse command from binary data
     static bool parse(uint8_t const* data, size_t size, Type& type, Config& config);
+    static bool parse(uint8_t const* data, size_t size, Command& command);
 };
 
 // Wrapper class for Status messages
@@ -112,8 +119,14 @@ public:
         // System
         uint64_t timestamp;
         float sim_time;
+
+        // Identity
+        uint32_t vehicle_id;
     };
 
+    // Create telemetry message (used by simulators and test tooling)
+    static std::vector<uint8_t> create(Telemetry const& telemetry);
+
     // Parse telemetry from binary data
     static bool parse(uint8_t const* data, size_t size, Telemetry& telemetry);
 };
@@ -127,9 +140,13 @@ public:
         float cyclic_lon;
         float pedals;
         uint64_t timestamp;
+        uint32_t vehicle_id;
     };
 
     // Create control message
     static std::vector<uint8_t> create(Control const& control);
+
+    // Parse control from binary data
+    static bool parse(uint8_t const* data, size_t size, Control& control);
 };
 } // namespace protocol
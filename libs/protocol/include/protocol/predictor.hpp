@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include "protocol/messages.hpp"
+
+namespace protocol {
+// Motion model used to extrapolate telemetry
+enum class PredictionModel {
+    Hold,                 // Latest frame as-is
+    ConstantVelocity,     // Straight-line fit
+    ConstantAcceleration  // Quadratic fit
+};
+
+struct PredictorOptions {
+    PredictionModel model = PredictionModel::ConstantVelocity;
+
+    // Number of recent frames the fit uses (at most TelemetryPredictor::HISTORY_SIZE)
+    std::size_t window = 4;
+
+    // Never extrapolate further than this past the newest frame, in seconds.
+    // Requests beyond it get the state at the horizon.
+    double max_horizon = 0.5;
+};
+
+// Difference between the prediction for a frame's time and the frame itself
+struct PredictionError {
+    double horizontal; // Metres
+    double vertical;   // Altitude units
+    double attitude;   // Largest roll / pitch / heading error, degrees
+    double speed;      // Largest airspeed / vertical / ground speed error
+    double horizon;    // How far ahead of the previous frame the prediction was, seconds
+};
+
+// Dead-reckoning predictor for one vehicle's telemetry.
+//
+// Keeps the kinematic channels (position, attitude, velocities) of the last
+// HISTORY_SIZE frames in a fixed ring, and extrapolates them to any requested
+// time with a least-squares polynomial fit. The fit only depends on the frame
+// times, so it reduces to one weight per frame; the prediction is then a
+// weighted sum of whole history rows, a branch-free loop over contiguous
+// doubles that the compiler vectorizes. Nothing allocates after construction.
+//
+// Heading, roll and longitude are unwrapped internally, so a turn through
+// north or a flight across the antimeridian extrapolates smoothly.
+// Non-kinematic fields (engine, controls, environment) are taken from the
+// latest frame.
+//
+// Times are seconds on any clock, as long as observe() and predict() agree;
+// the single-argument observe() uses the frame's own timestamp.
+class TelemetryPredictor {
+public:
+    using Telemetry = TelemetryMessage::Telemetry;
+
+    static constexpr std::size_t HISTORY_SIZE = 8;
+
+    explicit TelemetryPredictor(PredictorOptions const& options = {});
+
+    // Add a frame. If there was history to predict from, returns how far the
+    // prediction for this frame's time was off. Frames not newer than the
+    // latest one are ignored and return nullopt.
+    std::optional<PredictionError> observe(Telemetry const& telemetry, double time);
+    std::optional<PredictionError> observe(Telemetry const& telemetry);
+
+    // Extrapolated (or interpolated) state at the given time
+    [[nodiscard]] Telemetry predict(double time) const;
+
+    // Time of the newest frame, in the clock passed to observe()
+    [[nodiscard]] double latest_time() const;
+    [[nodiscard]] bool empty() const;
+
+    // Error statistics over every frame observed so far
+    [[nodiscard]] std::optional<PredictionError> last_error() const;
+    [[nodiscard]] uint64_t error_samples() const;
+    [[nodiscard]] double rms_horizontal_error() const;
+    [[nodiscard]] double rms_vertical_error() const;
+
+    void reset();
+
+    // Frame timestamp (milliseconds) in seconds
+    static double timestamp_seconds(Telemetry const& telemetry);
+
+private:
+    enum Channel : std::size_t {
+        LATITUDE,
+        LONGITUDE,
+        ALTITUDE,
+        ROLL,
+        PITCH,
+        HEADING,
+        AIRSPEED,
+        VERTICAL_SPEED,
+        GROUND_SPEED,
+        CHANNEL_COUNT
+    };
+
+    // Rows are padded to a multiple of four doubles so the weighted sum runs
+    // in whole vector registers
+    static constexpr std::size_t ROW_SIZE = (CHANNEL_COUNT + 3) / 4 * 4;
+    using Row = std::array<double, ROW_SIZE>;
+
+    [[nodiscard]] Row make_row(Telemetry const& telemetry) const;
+    [[nodiscard]] Row predict_row(double time) const;
+    [[nodiscard]] std::size_t slot(std::size_t age) const; // age 0 is the newest frame
+
+    PredictorOptions options_;
+    alignas(32) std::array<Row, HISTORY_SIZE> rows_{};
+    std::array<double, HISTORY_SIZE> times_{};
+    std::size_t count_;
+    std::size_t newest_;
+    Telemetry latest_{};
+
+    std::optional<PredictionError> last_error_;
+    uint64_t error_samples_;
+    double horizontal_square_sum_;
+    double vertical_square_sum_;
+};
+} // namespace protocol
@@ -1,4 +1,5 @@
 #include "protocol/messages.hpp"
+#include "protocol/message_type.hpp"
 #include "command_generated.h"
 #include "status_generated.h"
 #include "telemetry_generated.h"
@@ -6,6 +7,22 @@
 #include <chrono>
 
 namespace protocol {
+namespace {
+// Verify a buffer as root type T. Producers built before the schemas declared
+// file identifiers send buffers without one; those are verified by structure
+// alone, as they always were. A buffer carrying another type's identifier is
+// rejected without verifying.
+template <typename T>
+bool verify_buffer(uint8_t const* data, size_t size, MessageType type, char const* identifier) {
+    auto const found = identify(data, size);
+    if (found != type && found != MessageType::Unknown) {
+        return false;
+    }
+    flatbuffers::Verifier verifier(data, size);
+    return verifier.VerifyBuffer<T>(found == type ? identifier : nullptr);
+}
+} // namespace
+
 // Helper to get current timestamp in milliseconds
 uint64_t get_timestamp() {
     auto const now = std::chrono::system_clock::now();
@@ -27,7 +44,7 @@ std::vector<uint8_t> CommandMessage::create(Type type) {
         0 // No config
         );
 
-    builder.Finish(command);
+    fgsim::protocol::FinishCommandBuffer(builder, command);
 
     // Copy to std::vector
     uint8_t* buf = builder.GetBufferPointer();
@@ -65,7 +82,7 @@ std::vector<uint8_t> CommandMessage::create(Type type, Config const& config) {
         fb_config
         );
 
-    builder.Finish(command);
+    fgsim::protocol::FinishCommandBuffer(builder, command);
 
     // Copy to std::vector
     uint8_t* buf = builder.GetBufferPointer();
@@ -75,7 +92,7 @@ std::vector<uint8_t> CommandMessage::create(Type type, Config const& config) {
 
 bool CommandMessage::parse(uint8_t const* data, size_t size, Type& type, Config& config) {
     // Verify the buffer
-    if (flatbuffers::Verifier verifier(data, size); !fgsim::protocol::VerifyCommandBuffer(verifier)) {
+    if (!verify_buffer<fgsim::protocol::Command>(data, size, MessageType::Command, COMMAND_IDENTIFIER)) {
         return false;
     }
     auto const command = fgsim::protocol::GetCommand(data);
@@ -112,6 +129,11 @@ bool CommandMessage::parse(uint8_t const* data, size_t size, Type& type, Config&
     return true;
 }
 
+bool CommandMessage::parse(uint8_t const* data, size_t size, Command& command) {
+    command.config = Config{};
+    return parse(data, size, command.type, command.config);
+}
+
 // StatusMessage implementation
 std::vector<uint8_t> StatusMessage::create(StatusInfo const& info) {
     flatbuffers::FlatBufferBuilder builder(1024);
@@ -129,7 +151,7 @@ std::vector<uint8_t> StatusMessage::create(StatusInfo const& info) {
         info.mem_usage
         );
 
-    builder.Finish(status);
+    fgsim::protocol::FinishStatusBuffer(builder, status);
 
     // Copy to std::vector
     uint8_t* buf = builder.GetBufferPointer();
@@ -139,7 +161,7 @@ std::vector<uint8_t> StatusMessage::create(StatusInfo const& info) {
 
 bool StatusMessage::parse(uint8_t const* data, size_t size, StatusInfo& info) {
     // Verify the buffer
-    if (flatbuffers::Verifier verifier(data, size); !fgsim::protocol::VerifyStatusBuffer(verifier)) {
+    if (!verify_buffer<fgsim::protocol::Status>(data, size, MessageType::Status, STATUS_IDENTIFIER)) {
         return false;
     }
     auto const status = fgsim::protocol::GetStatus(data);
@@ -161,9 +183,46 @@ bool StatusMessage::parse(uint8_t const* data, size_t size, StatusInfo& info) {
 }
 
 // TelemetryMessage implementation
+std::vector<uint8_t> TelemetryMessage::create(Telemetry const& telemetry) {
+    flatbuffers::FlatBufferBuilder builder(256);
+
+    auto const fb_telemetry = fgsim::protocol::CreateHelicopterTelemetry(
+        builder,
+        telemetry.latitude,
+        telemetry.longitude,
+        telemetry.altitude,
+        telemetry.roll,
+        telemetry.pitch,
+        telemetry.heading,
+        telemetry.airspeed,
+        telemetry.vertical_speed,
+        telemetry.ground_speed,
+        telemetry.engine_rpm,
+        telemetry.rotor_rpm,
+        telemetry.collective,
+        telemetry.cyclic_lat,
+        telemetry.cyclic_lon,
+        telemetry.pedals,
+        telemetry.wind_speed,
+        telemetry.wind_direction,
+        telemetry.temperature,
+        telemetry.timestamp ? telemetry.timestamp : get_timestamp(),
+        telemetry.sim_time,
+        telemetry.vehicle_id
+        );
+
+    fgsim::protocol::FinishHelicopterTelemetryBuffer(builder, fb_telemetry);
+
+    // Copy to std::vector
+    uint8_t* buf = builder.GetBufferPointer();
+    size_t const size = builder.GetSize();
+    return {buf, buf + size};
+}
+
 bool TelemetryMessage::parse(uint8_t const* data, size_t size, Telemetry& telemetry) {
     // Verify the buffer
-    if (flatbuffers::Verifier verifier(data, size); !fgsim::protocol::VerifyHelicopterTelemetryBuffer(verifier)) {
+    if (!verify_buffer<fgsim::protocol::HelicopterTelemetry>(data, size, MessageType::Telemetry,
+            TELEMETRY_IDENTIFIER)) {
         return false;
     }
     auto const fb_telemetry = fgsim::protocol::GetHelicopterTelemetry(data);
@@ -196,6 +255,8 @@ bool TelemetryMessage::parse(uint8_t const* data, size_t size, Telemetry& teleme
     telemetry.timestamp = fb_telemetry->timestamp();
     telemetry.sim_time = fb_telemetry->sim_time();
 
+    telemetry.vehicle_id = fb_telemetry->vehicle_id();
+
     return true;
 }
 
@@ -211,14 +272,33 @@ std::vector<uint8_t> ControlMessage::create(Control const& control) {
         control.cyclic_lat,
         control.cyclic_lon,
         control.pedals,
-        timestamp
+        timestamp,
+        control.vehicle_id
         );
 
-    builder.Finish(fb_control);
+    // Not a root type, so there is no generated Finish*Buffer with the identifier
+    builder.Finish(fb_control, CONTROL_IDENTIFIER);
 
     // Copy to std::vector
     uint8_t* buf = builder.GetBufferPointer();
     size_t const size = builder.GetSize();
     return {buf, buf + size};
 }
+
+bool ControlMessage::parse(uint8_t const* data, size_t size, Control& control) {
+    // HelicopterControl is not the schema's root type; it is verified the same way
+    if (!verify_buffer<fgsim::protocol::HelicopterControl>(data, size, MessageType::Control, CONTROL_IDENTIFIER)) {
+        return false;
+    }
+    auto const fb_control = flatbuffers::GetRoot<fgsim::protocol::HelicopterControl>(data);
+
+    control.collective = fb_control->collective();
+    control.cyclic_lat = fb_control->cyclic_lat();
+    control.cyclic_lon = fb_control->cyclic_lon();
+    control.pedals = fb_control->pedals();
+    control.timestamp = fb_control->timestamp();
+    control.vehicle_id = fb_control->vehicle_id();
+
+    return true;
+}
 } // namespace protocol
@@ -0,0 +1,248 @@
+#include "protocol/predictor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace protocol {
+namespace {
+constexpr std::size_t MAX_TERMS = 3; // Up to a quadratic fit
+constexpr double METRES_PER_DEGREE = 111'320.0;
+
+// Least-squares weights: the polynomial of the given degree fitted to
+// (xs[i], y[i]) and evaluated at x equals sum(weights[i] * y[i]), for any y.
+// Returns false if the sample times can't support the degree.
+bool fit_weights(double const* xs, std::size_t n, std::size_t degree, double x, double* weights) {
+    auto const terms = degree + 1;
+
+    // Normal equations, augmented with the basis evaluated at x: solving
+    // (X^T X) v = phi(x) gives weights = X v
+    std::array<std::array<double, MAX_TERMS + 1>, MAX_TERMS> m{};
+    for (std::size_t i = 0; i < n; ++i) {
+        std::array<double, 2 * MAX_TERMS - 1> powers{};
+        powers[0] = 1.0;
+        for (std::size_t p = 1; p < 2 * terms - 1; ++p) {
+            powers[p] = powers[p - 1] * xs[i];
+        }
+        for (std::size_t j = 0; j < terms; ++j) {
+            for (std::size_t k = 0; k < terms; ++k) {
+                m[j][k] += powers[j + k];
+            }
+        }
+    }
+    double basis = 1.0;
+    for (std::size_t j = 0; j < terms; ++j) {
+        m[j][terms] = basis;
+        basis *= x;
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (std::size_t col = 0; col < terms; ++col) {
+        auto pivot = col;
+        for (std::size_t row = col + 1; row < terms; ++row) {
+            if (std::abs(m[row][col]) > std::abs(m[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(m[pivot][col]) < 1e-9) {
+            return false;
+        }
+        std::swap(m[col], m[pivot]);
+        for (std::size_t row = 0; row < terms; ++row) {
+            if (row != col) {
+                auto const factor = m[row][col] / m[col][col];
+                for (std::size_t k = col; k <= terms; ++k) {
+                    m[row][k] -= factor * m[col][k];
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        double weight = 0.0;
+        double power = 1.0;
+        for (std::size_t j = 0; j < terms; ++j) {
+            weight += power * m[j][terms] / m[j][j];
+            power *= xs[i];
+        }
+        weights[i] = weight;
+    }
+    return true;
+}
+
+// Continue a wrapping angle from the previous (unwrapped) value
+double unwrap(double angle, double previous) {
+    return previous + std::remainder(angle - previous, 360.0);
+}
+} // namespace
+
+TelemetryPredictor::TelemetryPredictor(PredictorOptions const& options)
+    : options_(options),
+      count_(0),
+      newest_(0),
+      error_samples_(0),
+      horizontal_square_sum_(0.0),
+      vertical_square_sum_(0.0) {
+    options_.window = std::clamp<std::size_t>(options_.window, 1, HISTORY_SIZE);
+}
+
+std::optional<PredictionError> TelemetryPredictor::observe(Telemetry const& telemetry, double time) {
+    if (count_ > 0 && !(time > times_[newest_])) {
+        return std::nullopt;
+    }
+
+    auto const row = make_row(telemetry);
+    std::optional<PredictionError> error;
+    if (count_ > 0) {
+        auto const predicted = predict_row(time);
+        auto const latitude = row[LATITUDE] * std::numbers::pi / 180.0;
+        auto const north = (predicted[LATITUDE] - row[LATITUDE]) * METRES_PER_DEGREE;
+        auto const east = (predicted[LONGITUDE] - row[LONGITUDE]) * METRES_PER_DEGREE * std::cos(latitude);
+
+        error = PredictionError{
+            std::hypot(north, east),
+            std::abs(predicted[ALTITUDE] - row[ALTITUDE]),
+            std::max({std::abs(predicted[ROLL] - row[ROLL]), std::abs(predicted[PITCH] - row[PITCH]),
+                      std::abs(predicted[HEADING] - row[HEADING])}),
+            std::max({std::abs(predicted[AIRSPEED] - row[AIRSPEED]),
+                      std::abs(predicted[VERTICAL_SPEED] - row[VERTICAL_SPEED]),
+                      std::abs(predicted[GROUND_SPEED] - row[GROUND_SPEED])}),
+            time - times_[newest_]};
+        last_error_ = error;
+        ++error_samples_;
+        horizontal_square_sum_ += error->horizontal * error->horizontal;
+        vertical_square_sum_ += error->vertical * error->vertical;
+    }
+
+    newest_ = count_ == 0 ? 0 : (newest_ + 1) % HISTORY_SIZE;
+    rows_[newest_] = row;
+    times_[newest_] = time;
+    count_ = std::min(count_ + 1, HISTORY_SIZE);
+    latest_ = telemetry;
+    return error;
+}
+
+std::optional<PredictionError> TelemetryPredictor::observe(Telemetry const& telemetry) {
+    return observe(telemetry, timestamp_seconds(telemetry));
+}
+
+TelemetryPredictor::Telemetry TelemetryPredictor::predict(double time) const {
+    auto telemetry = latest_;
+    if (count_ == 0) {
+        return telemetry;
+    }
+
+    auto const row = predict_row(time);
+    telemetry.latitude = row[LATITUDE];
+    telemetry.longitude = std::remainder(row[LONGITUDE], 360.0);
+    telemetry.altitude = row[ALTITUDE];
+    telemetry.roll = static_cast<float>(std::remainder(row[ROLL], 360.0));
+    telemetry.pitch = static_cast<float>(row[PITCH]);
+    auto heading = std::fmod(row[HEADING], 360.0);
+    telemetry.heading = static_cast<float>(heading < 0.0 ? heading + 360.0 : heading);
+    telemetry.airspeed = static_cast<float>(row[AIRSPEED]);
+    telemetry.vertical_speed = static_cast<float>(row[VERTICAL_SPEED]);
+    telemetry.ground_speed = static_cast<float>(row[GROUND_SPEED]);
+    telemetry.sim_time += static_cast<float>(std::min(time - times_[newest_], options_.max_horizon));
+    return telemetry;
+}
+
+double TelemetryPredictor::latest_time() const {
+    return count_ == 0 ? 0.0 : times_[newest_];
+}
+
+bool TelemetryPredictor::empty() const {
+    return count_ == 0;
+}
+
+std::optional<PredictionError> TelemetryPredictor::last_error() const {
+    return last_error_;
+}
+
+uint64_t TelemetryPredictor::error_samples() const {
+    return error_samples_;
+}
+
+double TelemetryPredictor::rms_horizontal_error() const {
+    return error_samples_ ? std::sqrt(horizontal_square_sum_ / static_cast<double>(error_samples_)) : 0.0;
+}
+
+double TelemetryPredictor::rms_vertical_error() const {
+    return error_samples_ ? std::sqrt(vertical_square_sum_ / static_cast<double>(error_samples_)) : 0.0;
+}
+
+void TelemetryPredictor::reset() {
+    count_ = 0;
+    newest_ = 0;
+    latest_ = {};
+    last_error_.reset();
+    error_samples_ = 0;
+    horizontal_square_sum_ = 0.0;
+    vertical_square_sum_ = 0.0;
+}
+
+double TelemetryPredictor::timestamp_seconds(Telemetry const& telemetry) {
+    return static_cast<double>(telemetry.timestamp) * 1e-3;
+}
+
+TelemetryPredictor::Row TelemetryPredictor::make_row(Telemetry const& telemetry) const {
+    Row row{};
+    row[LATITUDE] = telemetry.latitude;
+    row[LONGITUDE] = telemetry.longitude;
+    row[ALTITUDE] = telemetry.altitude;
+    row[ROLL] = telemetry.roll;
+    row[PITCH] = telemetry.pitch;
+    row[HEADING] = telemetry.heading;
+    row[AIRSPEED] = telemetry.airspeed;
+    row[VERTICAL_SPEED] = telemetry.vertical_speed;
+    row[GROUND_SPEED] = telemetry.ground_speed;
+
+    if (count_ > 0) {
+        auto const& previous = rows_[newest_];
+        row[LONGITUDE] = unwrap(row[LONGITUDE], previous[LONGITUDE]);
+        row[ROLL] = unwrap(row[ROLL], previous[ROLL]);
+        row[HEADING] = unwrap(row[HEADING], previous[HEADING]);
+    }
+    return row;
+}
+
+TelemetryPredictor::Row TelemetryPredictor::predict_row(double time) const {
+    auto const n = std::min(count_, options_.window);
+    auto const newest_time = times_[newest_];
+    auto const oldest_time = times_[slot(n - 1)];
+
+    // Sample times relative to the newest frame, scaled by the span of the
+    // window so the fit stays well conditioned at any frame rate
+    auto const span = std::max(newest_time - oldest_time, 1e-6);
+    std::array<double, HISTORY_SIZE> xs{};
+    for (std::size_t age = 0; age < n; ++age) {
+        xs[age] = (times_[slot(age)] - newest_time) / span;
+    }
+    auto const x = std::clamp(time, oldest_time, newest_time + options_.max_horizon) - newest_time;
+
+    std::array<double, HISTORY_SIZE> weights{};
+    weights[0] = 1.0;
+    auto degree = std::min<std::size_t>(static_cast<std::size_t>(options_.model), n - 1);
+    while (degree > 0 && !fit_weights(xs.data(), n, degree, x / span, weights.data())) {
+        --degree;
+    }
+    if (degree == 0) {
+        // Hold (or too little history for a fit): newest frame only
+        weights = {};
+        weights[0] = 1.0;
+    }
+
+    Row row{};
+    for (std::size_t age = 0; age < n; ++age) {
+        auto const weight = weights[age];
+        auto const& sample = rows_[slot(age)];
+        for (std::size_t channel = 0; channel < ROW_SIZE; ++channel) {
+            row[channel] += weight * sample[channel];
+        }
+    }
+    return row;
+}
+
+std::size_t TelemetryPredictor::slot(std::size_t age) const {
+    return (newest_ + HISTORY_SIZE - age) % HISTORY_SIZE;
+}
+} // namespace protocol